@@ -0,0 +1,193 @@
+#include "alloc.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Block header: the requested size, padded so the block stays aligned
+#define ALLOC_HEADER 16
+#define ALLOC_MAX_SITES 256
+
+typedef struct {
+    uint64_t allocations;
+    uint64_t bytes;
+    int64_t liveBytes;
+    int64_t peakBytes;
+} KindStats;
+
+typedef struct {
+    const char* site; // set once with compare-and-swap
+    AllocKind kind;
+    uint64_t allocations;
+    uint64_t bytes;
+} SiteStats;
+
+static KindStats kinds[ALLOC_KIND_COUNT];
+static int64_t liveBytes;
+static int64_t peakBytes;
+static SiteStats sites[ALLOC_MAX_SITES];
+static uint64_t untrackedSites; // allocations from sites past the table
+
+static const char* kindNames[ALLOC_KIND_COUNT] = {"heap", "surface", "texture", "mixer"};
+
+const char* allocKindName(AllocKind kind) {
+    return kind >= 0 && kind < ALLOC_KIND_COUNT ? kindNames[kind] : "?";
+}
+
+static void raisePeak(int64_t* peak, int64_t value) {
+    int64_t seen = __atomic_load_n(peak, __ATOMIC_RELAXED);
+    while (value > seen &&
+           !__atomic_compare_exchange_n(peak, &seen, value, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+static void adjustLive(AllocKind kind, int64_t delta) {
+    int64_t kindLive = __atomic_add_fetch(&kinds[kind].liveBytes, delta, __ATOMIC_RELAXED);
+    int64_t live = __atomic_add_fetch(&liveBytes, delta, __ATOMIC_RELAXED);
+    if (delta > 0) {
+        raisePeak(&kinds[kind].peakBytes, kindLive);
+        raisePeak(&peakBytes, live);
+    }
+}
+
+// Site strings are literals, so the pointer identifies the site
+static SiteStats* findSite(const char* site, AllocKind kind) {
+    size_t start = ((uintptr_t)site >> 3) % ALLOC_MAX_SITES;
+    for (size_t probe = 0; probe < ALLOC_MAX_SITES; probe++) {
+        SiteStats* entry = &sites[(start + probe) % ALLOC_MAX_SITES];
+        const char* current = __atomic_load_n(&entry->site, __ATOMIC_ACQUIRE);
+        if (current == site) return entry;
+        if (!current) {
+            const char* expected = NULL;
+            entry->kind = kind;
+            if (__atomic_compare_exchange_n(&entry->site, &expected, site, false,
+                                            __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) ||
+                expected == site) {
+                return entry;
+            }
+        }
+    }
+    return NULL;
+}
+
+static void countAllocation(AllocKind kind, size_t bytes, const char* site) {
+    __atomic_add_fetch(&kinds[kind].allocations, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&kinds[kind].bytes, bytes, __ATOMIC_RELAXED);
+    SiteStats* entry = findSite(site, kind);
+    if (entry) {
+        __atomic_add_fetch(&entry->allocations, 1, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&entry->bytes, bytes, __ATOMIC_RELAXED);
+    } else {
+        __atomic_add_fetch(&untrackedSites, 1, __ATOMIC_RELAXED);
+    }
+}
+
+void* allocHeap(void* block, size_t size, const char* site) {
+    size_t oldSize = 0;
+    unsigned char* base = NULL;
+    if (block) {
+        base = (unsigned char*)block - ALLOC_HEADER;
+        memcpy(&oldSize, base, sizeof(oldSize));
+    }
+    unsigned char* grown = realloc(base, ALLOC_HEADER + size);
+    if (!grown) return NULL;
+    memcpy(grown, &size, sizeof(size));
+    countAllocation(ALLOC_HEAP, size, site);
+    adjustLive(ALLOC_HEAP, (int64_t)size - (int64_t)oldSize);
+    return grown + ALLOC_HEADER;
+}
+
+void* allocZeroed(size_t count, size_t size, const char* site) {
+    if (size > 0 && count > SIZE_MAX / size) return NULL;
+    void* block = allocHeap(NULL, count * size, site);
+    if (block) memset(block, 0, count * size);
+    return block;
+}
+
+void allocFree(void* block) {
+    if (!block) return;
+    unsigned char* base = (unsigned char*)block - ALLOC_HEADER;
+    size_t size;
+    memcpy(&size, base, sizeof(size));
+    adjustLive(ALLOC_HEAP, -(int64_t)size);
+    free(base);
+}
+
+void allocNote(AllocKind kind, size_t bytes, const char* site) {
+    countAllocation(kind, bytes, site);
+    adjustLive(kind, (int64_t)bytes);
+}
+
+void allocNoteFree(AllocKind kind, size_t bytes) {
+    adjustLive(kind, -(int64_t)bytes);
+}
+
+void allocKindTotals(AllocKind kind, AllocTotals* totals) {
+    totals->allocations = __atomic_load_n(&kinds[kind].allocations, __ATOMIC_RELAXED);
+    totals->bytes = __atomic_load_n(&kinds[kind].bytes, __ATOMIC_RELAXED);
+    totals->liveBytes = __atomic_load_n(&kinds[kind].liveBytes, __ATOMIC_RELAXED);
+    totals->peakBytes = __atomic_load_n(&kinds[kind].peakBytes, __ATOMIC_RELAXED);
+}
+
+void allocTotals(AllocTotals* totals) {
+    memset(totals, 0, sizeof(*totals));
+    for (int k = 0; k < ALLOC_KIND_COUNT; k++) {
+        totals->allocations += __atomic_load_n(&kinds[k].allocations, __ATOMIC_RELAXED);
+        totals->bytes += __atomic_load_n(&kinds[k].bytes, __ATOMIC_RELAXED);
+    }
+    totals->liveBytes = __atomic_load_n(&liveBytes, __ATOMIC_RELAXED);
+    totals->peakBytes = __atomic_load_n(&peakBytes, __ATOMIC_RELAXED);
+}
+
+void allocResetPeak(void) {
+    for (int k = 0; k < ALLOC_KIND_COUNT; k++) {
+        __atomic_store_n(&kinds[k].peakBytes, __atomic_load_n(&kinds[k].liveBytes, __ATOMIC_RELAXED),
+                         __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&peakBytes, __atomic_load_n(&liveBytes, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+}
+
+void allocResetCounts(void) {
+    for (int k = 0; k < ALLOC_KIND_COUNT; k++) {
+        __atomic_store_n(&kinds[k].allocations, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&kinds[k].bytes, 0, __ATOMIC_RELAXED);
+    }
+    for (int s = 0; s < ALLOC_MAX_SITES; s++) {
+        __atomic_store_n(&sites[s].allocations, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&sites[s].bytes, 0, __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&untrackedSites, 0, __ATOMIC_RELAXED);
+}
+
+static int compareSites(const void* a, const void* b) {
+    const SiteStats* x = *(const SiteStats* const*)a;
+    const SiteStats* y = *(const SiteStats* const*)b;
+    return (y->allocations > x->allocations) - (y->allocations < x->allocations);
+}
+
+void allocReport(FILE* out) {
+    fprintf(out, "%-10s %12s %14s %12s %12s\n", "kind", "allocations", "bytes", "live", "peak");
+    for (int k = 0; k < ALLOC_KIND_COUNT; k++) {
+        AllocTotals totals;
+        allocKindTotals(k, &totals);
+        fprintf(out, "%-10s %12llu %14llu %12lld %12lld\n", kindNames[k],
+                (unsigned long long)totals.allocations, (unsigned long long)totals.bytes,
+                (long long)totals.liveBytes, (long long)totals.peakBytes);
+    }
+
+    const SiteStats* used[ALLOC_MAX_SITES];
+    int usedCount = 0;
+    for (int s = 0; s < ALLOC_MAX_SITES; s++) {
+        if (sites[s].site && sites[s].allocations > 0) used[usedCount++] = &sites[s];
+    }
+    if (usedCount == 0) return;
+    qsort(used, (size_t)usedCount, sizeof(used[0]), compareSites);
+    fprintf(out, "%-32s %-8s %12s %14s\n", "site", "kind", "allocations", "bytes");
+    for (int i = 0; i < usedCount; i++) {
+        fprintf(out, "%-32s %-8s %12llu %14llu\n", used[i]->site, kindNames[used[i]->kind],
+                (unsigned long long)used[i]->allocations, (unsigned long long)used[i]->bytes);
+    }
+    if (untrackedSites > 0) {
+        fprintf(out, "(%llu allocations from sites past the %d-site table)\n",
+                (unsigned long long)untrackedSites, ALLOC_MAX_SITES);
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef ALLOC_H
+#define ALLOC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Allocation tracking. Heap blocks owned by the game loop's data
+// structures go through the TRACKED_* macros, which keep a small size
+// header in front of each block; SDL surfaces and textures and mixer
+// objects are reported with allocNote when created and destroyed. Every
+// allocation is counted per kind and per call site (file:line), and live
+// bytes and their peak are kept per kind. The profiler takes per-frame
+// figures from allocTotals, and the headless runner uses them to fail a
+// run whose steady state allocates at all.
+//
+// Memory from TRACKED_MALLOC/CALLOC/REALLOC must go back through
+// TRACKED_FREE (and plain malloc blocks through free).
+
+typedef enum {
+    ALLOC_HEAP,
+    ALLOC_SURFACE,
+    ALLOC_TEXTURE,
+    ALLOC_MIXER, // chunks with their sample bytes; music streams as 0 bytes
+    ALLOC_KIND_COUNT
+} AllocKind;
+
+typedef struct {
+    uint64_t allocations; // reallocs count as allocations
+    uint64_t bytes;       // requested, summed over allocations
+    int64_t liveBytes;
+    int64_t peakBytes;    // since the last allocResetPeak
+} AllocTotals;
+
+#define ALLOC_STRINGIFY_(x) #x
+#define ALLOC_STRINGIFY(x) ALLOC_STRINGIFY_(x)
+#define ALLOC_SITE __FILE__ ":" ALLOC_STRINGIFY(__LINE__)
+
+#define TRACKED_MALLOC(size) allocHeap(NULL, (size), ALLOC_SITE)
+#define TRACKED_CALLOC(count, size) allocZeroed((count), (size), ALLOC_SITE)
+#define TRACKED_REALLOC(block, size) allocHeap((block), (size), ALLOC_SITE)
+#define TRACKED_FREE(block) allocFree(block)
+
+void* allocHeap(void* block, size_t size, const char* site); // realloc semantics
+void* allocZeroed(size_t count, size_t size, const char* site);
+void allocFree(void* block);
+
+void allocNote(AllocKind kind, size_t bytes, const char* site);
+void allocNoteFree(AllocKind kind, size_t bytes);
+
+const char* allocKindName(AllocKind kind);
+void allocKindTotals(AllocKind kind, AllocTotals* totals);
+void allocTotals(AllocTotals* totals); // all kinds together
+void allocResetPeak(void);             // peaks restart from the live bytes
+void allocResetCounts(void);           // allocation counts and bytes (kinds and sites) restart at 0
+void allocReport(FILE* out);           // per kind, then per site by count
+
+#endif
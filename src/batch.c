@@ -0,0 +1,80 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "batch.h"
+#include "bignum.h"
+
+void batchDefaultOptions(BatchOptions* options, int games) {
+    memset(options, 0, sizeof(*options));
+    options->games = games;
+    options->threads = sysconf(_SC_NPROCESSORS_ONLN);
+    options->number = "42";
+    options->type = CONVERSION_DECIMAL;
+    options->model = BOT_AUTOPLAY;
+    options->seed = simClockSeed();
+    options->maxMinutes = BATCH_DEFAULT_MAX_MINUTES;
+}
+
+bool batchParseOption(BatchOptions* options, int argc, char* argv[], int* i) {
+    const char* arg = argv[*i];
+    if (*i + 1 >= argc) return false;
+    if (strcmp(arg, "--games") == 0) {
+        options->games = atoi(argv[++*i]);
+    } else if (strcmp(arg, "--threads") == 0) {
+        options->threads = atol(argv[++*i]);
+    } else if (strcmp(arg, "--number") == 0) {
+        options->number = argv[++*i];
+    } else if (strcmp(arg, "--type") == 0) {
+        const char* name = argv[++*i];
+        if (strcmp(name, "oct") == 0) options->type = CONVERSION_OCTAL;
+        else if (strcmp(name, "hex") == 0) options->type = CONVERSION_HEXADECIMAL;
+        else options->type = CONVERSION_DECIMAL;
+    } else if (strcmp(arg, "--seed") == 0) {
+        options->seed = strtoull(argv[++*i], NULL, 10);
+    } else if (strcmp(arg, "--max-minutes") == 0) {
+        options->maxMinutes = atol(argv[++*i]);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool batchCheckOptions(BatchOptions* options) {
+    if (options->threads < 1) options->threads = 1;
+    if (options->games < 1) options->games = 1;
+    if (options->maxMinutes < 1) options->maxMinutes = 1;
+    options->maxTicks = (uint32_t)(options->maxMinutes * 60 * SIM_TICK_RATE);
+
+    BitVector check;
+    if (!convertDigitsToBinary(options->number, options->type, &check)) {
+        printf("Invalid number for this conversion type: %s\n", options->number);
+        return false;
+    }
+    return true;
+}
+
+void batchPlayGame(GameState* game, const BatchOptions* options, int n, GameResult* result) {
+    Bot bot = {options->model, 0};
+    simSetSeed(game, options->seed + (uint64_t)n);
+    initGameFromDigits(game, options->number, options->type);
+    botPlay(&bot, game, options->maxTicks);
+    result->level = game->level;
+    result->score = game->score;
+    result->ticks = game->tick;
+    result->capped = !game->gameOver;
+}
+
+double batchNowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int batchCompareInts(const void* a, const void* b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
+}
@@ -0,0 +1,47 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sim.h"
+#include "bot.h"
+
+// Shared by the batch runners (bqmonte, bqsweep): the options they have in
+// common and playing game n of a batch with the bot. Game n always uses
+// seed + n, so results depend only on the options, not on the threads.
+
+#define BATCH_DEFAULT_MAX_MINUTES 10
+
+typedef struct {
+    int level;
+    int score;
+    uint32_t ticks;
+    bool capped; // still running at the tick limit
+} GameResult;
+
+typedef struct {
+    int games;
+    long threads;
+    const char* number;
+    ConversionType type;
+    BotModel model;
+    uint64_t seed;
+    long maxMinutes;
+    uint32_t maxTicks; // from maxMinutes, set by batchCheckOptions
+} BatchOptions;
+
+void batchDefaultOptions(BatchOptions* options, int games);
+// Takes argv[*i] and its value if it is one of --games, --threads,
+// --number, --type, --seed or --max-minutes; false for anything else
+bool batchParseOption(BatchOptions* options, int argc, char* argv[], int* i);
+// Clamps the counts to at least 1 and checks the number can be converted;
+// false (after saying why) if it cannot
+bool batchCheckOptions(BatchOptions* options);
+
+// Play game n until it ends or reaches the tick limit
+void batchPlayGame(GameState* game, const BatchOptions* options, int n, GameResult* result);
+
+double batchNowSeconds(void);
+int batchCompareInts(const void* a, const void* b); // for qsort
+
+#endif
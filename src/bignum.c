@@ -0,0 +1,582 @@
+#include "bignum.h"
+#include "radix.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Below these sizes the simple quadratic algorithms are faster
+#define SCHOOLBOOK_CHUNKS 32
+#define KARATSUBA_THRESHOLD 32
+
+// Powers base^(2^j) shared by one chunked parse, where base is the radix
+// raised to the most digits that fit a limb (10^19 for decimal)
+#define MAX_POWERS 48
+
+typedef struct {
+    int radix;
+    int chunkDigits;
+    uint64_t chunkBase;
+    BigNum pows[MAX_POWERS];
+    int count;
+} PowerTable;
+
+void bignumInit(BigNum* n) {
+    n->limbs = NULL;
+    n->count = 0;
+    n->capacity = 0;
+}
+
+void bignumFree(BigNum* n) {
+    free(n->limbs);
+    bignumInit(n);
+}
+
+static bool bignumReserve(BigNum* n, size_t capacity) {
+    if (capacity <= n->capacity) {
+        return true;
+    }
+    uint64_t* limbs = realloc(n->limbs, capacity * sizeof(uint64_t));
+    if (!limbs) {
+        return false;
+    }
+    n->limbs = limbs;
+    n->capacity = capacity;
+    return true;
+}
+
+static void bignumNormalize(BigNum* n) {
+    while (n->count > 0 && n->limbs[n->count - 1] == 0) {
+        n->count--;
+    }
+}
+
+// r[0..rn) += a[0..an) with rn >= an; returns the carry out of r
+static uint64_t addLimbs(uint64_t* r, size_t rn, const uint64_t* a, size_t an) {
+    uint64_t carry = 0;
+    size_t i;
+    for (i = 0; i < an; i++) {
+        uint64_t sum = r[i] + carry;
+        carry = sum < carry;
+        sum += a[i];
+        carry += sum < a[i];
+        r[i] = sum;
+    }
+    for (; carry && i < rn; i++) {
+        r[i]++;
+        carry = r[i] == 0;
+    }
+    return carry;
+}
+
+// r[0..rn) -= a[0..an); the caller guarantees r >= a
+static void subLimbs(uint64_t* r, size_t rn, const uint64_t* a, size_t an) {
+    uint64_t borrow = 0;
+    size_t i;
+    for (i = 0; i < an; i++) {
+        uint64_t value = r[i];
+        r[i] = value - a[i] - borrow;
+        borrow = (value < a[i]) || (value - a[i] < borrow);
+    }
+    for (; borrow && i < rn; i++) {
+        borrow = r[i] == 0;
+        r[i]--;
+    }
+}
+
+// r[0..an+bn) = a * b
+static void mulSchoolbook(uint64_t* r, const uint64_t* a, size_t an, const uint64_t* b, size_t bn) {
+    memset(r, 0, (an + bn) * sizeof(uint64_t));
+    for (size_t i = 0; i < an; i++) {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < bn; j++) {
+            uint64_t hi;
+            uint64_t lo = mulWide64(a[i], b[j], &hi);
+            lo += carry;
+            hi += lo < carry;
+            lo += r[i + j];
+            hi += lo < r[i + j];
+            r[i + j] = lo;
+            carry = hi;
+        }
+        r[i + bn] = carry;
+    }
+}
+
+// r[0..an+bn) = a * b using Karatsuba above the threshold
+static bool mulLimbs(uint64_t* r, const uint64_t* a, size_t an, const uint64_t* b, size_t bn) {
+    if (an < bn) {
+        const uint64_t* t = a; a = b; b = t;
+        size_t tn = an; an = bn; bn = tn;
+    }
+    if (bn < KARATSUBA_THRESHOLD) {
+        mulSchoolbook(r, a, an, b, bn);
+        return true;
+    }
+
+    size_t m = an / 2;
+    if (bn <= m) {
+        // Unbalanced: split only a and multiply each half by b
+        size_t highLimbs = an - m + bn;
+        uint64_t* t = malloc(highLimbs * sizeof(uint64_t));
+        if (!t) {
+            return false;
+        }
+        bool ok = mulLimbs(r, a, m, b, bn) && mulLimbs(t, a + m, an - m, b, bn);
+        if (ok) {
+            memset(r + m + bn, 0, (an - m) * sizeof(uint64_t));
+            addLimbs(r + m, an + bn - m, t, highLimbs);
+        }
+        free(t);
+        return ok;
+    }
+
+    // z0 = a0*b0 into the low half of r, z2 = a1*b1 into the high half
+    size_t a1n = an - m, b1n = bn - m;
+    if (!mulLimbs(r, a, m, b, m) || !mulLimbs(r + 2 * m, a + m, a1n, b + m, b1n)) {
+        return false;
+    }
+
+    // z1 = (a0 + a1)(b0 + b1) - z0 - z2
+    size_t san = a1n + 1;
+    size_t sbn = (m > b1n ? m : b1n) + 1;
+    size_t zn = san + sbn;
+    uint64_t* scratch = malloc((san + sbn + zn) * sizeof(uint64_t));
+    if (!scratch) {
+        return false;
+    }
+    uint64_t* sa = scratch;
+    uint64_t* sb = sa + san;
+    uint64_t* z1 = sb + sbn;
+
+    memcpy(sa, a + m, a1n * sizeof(uint64_t));
+    sa[a1n] = 0;
+    addLimbs(sa, san, a, m);
+
+    memset(sb, 0, sbn * sizeof(uint64_t));
+    if (m >= b1n) {
+        memcpy(sb, b, m * sizeof(uint64_t));
+        addLimbs(sb, sbn, b + m, b1n);
+    } else {
+        memcpy(sb, b + m, b1n * sizeof(uint64_t));
+        addLimbs(sb, sbn, b, m);
+    }
+
+    bool ok = mulLimbs(z1, sa, san, sb, sbn);
+    if (ok) {
+        subLimbs(z1, zn, r, 2 * m);
+        subLimbs(z1, zn, r + 2 * m, a1n + b1n);
+        while (zn > an + bn - m && z1[zn - 1] == 0) {
+            zn--;
+        }
+        addLimbs(r + m, an + bn - m, z1, zn);
+    }
+    free(scratch);
+    return ok;
+}
+
+// Octal and hex: every digit is a fixed group of bits, packed from the
+// least significant end in one pass
+static bool parsePowerOfTwo(BigNum* n, const char* digits, size_t length, int radix) {
+    int bitsPerDigit = radixDigitBits(radix);
+    size_t limbCount = (length * bitsPerDigit + 63) / 64;
+    if (!bignumReserve(n, limbCount)) {
+        return false;
+    }
+    memset(n->limbs, 0, limbCount * sizeof(uint64_t));
+
+    size_t bitPos = 0;
+    for (size_t i = length; i-- > 0;) {
+        int value = radixDigitValue(digits[i], radix);
+        if (value < 0) {
+            return false;
+        }
+        size_t limb = bitPos / 64;
+        size_t shift = bitPos % 64;
+        n->limbs[limb] |= (uint64_t)value << shift;
+        if (shift + bitsPerDigit > 64) {
+            n->limbs[limb + 1] |= (uint64_t)value >> (64 - shift);
+        }
+        bitPos += bitsPerDigit;
+    }
+
+    n->count = limbCount;
+    bignumNormalize(n);
+    return true;
+}
+
+// Base case: multiply-add one limb-sized chunk of digits at a time
+static bool chunkSchoolbook(BigNum* out, const char* digits, size_t length, const PowerTable* table) {
+    size_t chunkDigits = (size_t)table->chunkDigits;
+    if (!bignumReserve(out, length / chunkDigits + 1)) {
+        return false;
+    }
+    out->count = 0;
+
+    size_t pos = 0;
+    size_t take = length % chunkDigits;
+    if (take == 0) {
+        take = chunkDigits;
+    }
+    while (pos < length) {
+        uint64_t chunk = 0;
+        uint64_t scale = 1;
+        for (size_t k = 0; k < take; k++) {
+            chunk = chunk * (uint64_t)table->radix + (uint64_t)radixDigitValue(digits[pos + k], table->radix);
+            scale *= (uint64_t)table->radix;
+        }
+
+        uint64_t carry = chunk;
+        for (size_t i = 0; i < out->count; i++) {
+            uint64_t hi;
+            uint64_t lo = mulWide64(out->limbs[i], scale, &hi);
+            lo += carry;
+            hi += lo < carry;
+            out->limbs[i] = lo;
+            carry = hi;
+        }
+        if (carry) {
+            out->limbs[out->count++] = carry;
+        }
+
+        pos += take;
+        take = chunkDigits;
+    }
+    return true;
+}
+
+// Make sure table->pows[j] = chunkBase^(2^j) exists
+static bool powerTableEnsure(PowerTable* table, int j) {
+    if (j >= MAX_POWERS) {
+        return false;
+    }
+    while (table->count <= j) {
+        BigNum* p = &table->pows[table->count];
+        bignumInit(p);
+        if (table->count == 0) {
+            if (!bignumReserve(p, 1)) {
+                return false;
+            }
+            p->limbs[0] = table->chunkBase;
+            p->count = 1;
+        } else {
+            const BigNum* prev = &table->pows[table->count - 1];
+            if (!bignumReserve(p, prev->count * 2) ||
+                !mulLimbs(p->limbs, prev->limbs, prev->count, prev->limbs, prev->count)) {
+                bignumFree(p);
+                return false;
+            }
+            p->count = prev->count * 2;
+            bignumNormalize(p);
+        }
+        table->count++;
+    }
+    return true;
+}
+
+// Divide and conquer: the low chunkDigits*2^j digits and the high rest are
+// converted separately and recombined as high * chunkBase^(2^j) + low
+static bool chunkedToLimbs(BigNum* out, const char* digits, size_t length, PowerTable* table) {
+    size_t chunkDigits = (size_t)table->chunkDigits;
+    size_t chunks = (length + chunkDigits - 1) / chunkDigits;
+    if (chunks <= SCHOOLBOOK_CHUNKS) {
+        return chunkSchoolbook(out, digits, length, table);
+    }
+
+    int j = 0;
+    while (((size_t)2 << j) < chunks) {
+        j++;
+    }
+    size_t lowDigits = ((size_t)1 << j) * chunkDigits;
+    size_t highDigits = length - lowDigits;
+    if (!powerTableEnsure(table, j)) {
+        return false;
+    }
+    const BigNum* power = &table->pows[j];
+
+    BigNum high, low;
+    bignumInit(&high);
+    bignumInit(&low);
+    bool ok = chunkedToLimbs(&high, digits, highDigits, table) &&
+              chunkedToLimbs(&low, digits + highDigits, lowDigits, table);
+
+    if (ok && high.count == 0) {
+        bignumFree(out);
+        *out = low;
+        bignumInit(&low);
+    } else if (ok) {
+        size_t productLimbs = high.count + power->count;
+        ok = bignumReserve(out, productLimbs) &&
+             mulLimbs(out->limbs, high.limbs, high.count, power->limbs, power->count);
+        if (ok) {
+            out->count = productLimbs;
+            addLimbs(out->limbs, out->count, low.limbs, low.count);
+            bignumNormalize(out);
+        }
+    }
+
+    bignumFree(&high);
+    bignumFree(&low);
+    return ok;
+}
+
+bool bignumParse(BigNum* n, const char* digits, size_t length, int radix) {
+    n->count = 0;
+    if (length == 0 || radixChunkDigits(radix) == 0) {
+        return false;
+    }
+    if (radixDigitBits(radix)) {
+        return parsePowerOfTwo(n, digits, length, radix);
+    }
+
+    for (size_t i = 0; i < length; i++) {
+        if (radixDigitValue(digits[i], radix) < 0) {
+            return false;
+        }
+    }
+    PowerTable table;
+    table.radix = radix;
+    table.chunkDigits = radixChunkDigits(radix);
+    table.chunkBase = radixChunkBase(radix);
+    table.count = 0;
+    bool ok = chunkedToLimbs(n, digits, length, &table);
+    for (int i = 0; i < table.count; i++) {
+        bignumFree(&table.pows[i]);
+    }
+    if (ok) {
+        bignumNormalize(n);
+    }
+    return ok;
+}
+
+bool bignumParseType(BigNum* n, const char* digits, size_t length, ConversionType type) {
+    switch (type) {
+        case CONVERSION_OCTAL:
+            return bignumParse(n, digits, length, 8);
+        case CONVERSION_HEXADECIMAL:
+            return bignumParse(n, digits, length, 16);
+        case CONVERSION_DECIMAL:
+        default:
+            return bignumParse(n, digits, length, 10);
+    }
+}
+
+size_t bignumBitLength(const BigNum* n) {
+    if (n->count == 0) {
+        return 0;
+    }
+    return (n->count - 1) * 64 + (size_t)bitLength64(n->limbs[n->count - 1]);
+}
+
+bool bignumToBitVector(const BigNum* n, BitVector* out) {
+    size_t length = bignumBitLength(n);
+    if (length > BITVEC_MAX_BITS) {
+        return false;
+    }
+    bitvecClear(out);
+    for (size_t i = 0; i < n->count; i++) {
+        out->words[i] = n->limbs[i];
+    }
+    out->length = length ? (int)length : 1;
+    return true;
+}
+
+size_t bignumFormatBinary(const BigNum* n, char* out, size_t outSize) {
+    size_t length = bignumBitLength(n);
+    size_t needed = length ? length : 1;
+    if (outSize == 0) {
+        return needed;
+    }
+
+    size_t written = needed < outSize - 1 ? needed : outSize - 1;
+    for (size_t i = 0; i < written; i++) {
+        size_t pos = needed - 1 - i;
+        int bit = length ? (int)((n->limbs[pos / 64] >> (pos % 64)) & 1u) : 0;
+        out[i] = bit ? '1' : '0';
+    }
+    out[written] = '\0';
+    return needed;
+}
+
+bool convertDigitsToBinary(const char* digits, ConversionType type, BitVector* out) {
+    BigNum n;
+    bignumInit(&n);
+    bool ok = bignumParseType(&n, digits, strlen(digits), type) && bignumToBitVector(&n, out);
+    bignumFree(&n);
+    return ok;
+}
+
+// Reference for the self-test: one digit at a time into 32-bit words, with
+// no chunks, no power table and no Karatsuba. Writes binary like
+// bignumFormatBinary; words needs length / 5 + 2 entries (6 bits a digit).
+static void referenceBinary(const char* digits, size_t length, int radix, uint32_t* words, char* out) {
+    size_t count = 0;
+    for (size_t i = 0; i < length; i++) {
+        uint64_t carry = (uint64_t)radixDigitValue(digits[i], radix);
+        for (size_t w = 0; w < count; w++) {
+            uint64_t value = (uint64_t)words[w] * (uint64_t)radix + carry;
+            words[w] = (uint32_t)value;
+            carry = value >> 32;
+        }
+        if (carry) words[count++] = (uint32_t)carry;
+    }
+    size_t bits = count ? (count - 1) * 32 + (size_t)bitLength64(words[count - 1]) : 0;
+    if (bits == 0) {
+        strcpy(out, "0");
+        return;
+    }
+    for (size_t i = 0; i < bits; i++) {
+        size_t pos = bits - 1 - i;
+        out[i] = (words[pos / 32] >> (pos % 32)) & 1u ? '1' : '0';
+    }
+    out[bits] = '\0';
+}
+
+// Parse digits both ways and compare; for the game's radixes also through
+// convertDigitsToBinary, which must accept exactly the values that fit
+// BITVEC_MAX_BITS
+static bool checkDigits(const char* digits, int radix, const char* what) {
+    static const ConversionType types[17] = {[8] = CONVERSION_OCTAL, [10] = CONVERSION_DECIMAL,
+                                             [16] = CONVERSION_HEXADECIMAL};
+    size_t length = strlen(digits);
+    size_t outSize = length * 6 + 2;
+    uint32_t* words = malloc((length / 5 + 2) * sizeof(uint32_t));
+    char* expected = malloc(outSize);
+    char* actual = malloc(outSize);
+    BigNum n;
+    bignumInit(&n);
+    bool ok = words && expected && actual && bignumParse(&n, digits, length, radix);
+    if (ok) {
+        referenceBinary(digits, length, radix, words, expected);
+        bignumFormatBinary(&n, actual, outSize);
+        ok = strcmp(expected, actual) == 0;
+    }
+    if (ok && (radix == 8 || radix == 10 || radix == 16)) {
+        BitVector v;
+        bool fits = strlen(expected) <= BITVEC_MAX_BITS;
+        ok = convertDigitsToBinary(digits, types[radix], &v) == fits;
+        if (ok && fits) {
+            bitvecFormat(&v, actual, (int)outSize);
+            ok = strcmp(expected, actual) == 0;
+        }
+    }
+    if (!ok) {
+        printf("bignum check failed: radix %d, %s (%zu digits)\n", radix, what, length);
+    }
+    bignumFree(&n);
+    free(words);
+    free(expected);
+    free(actual);
+    return ok;
+}
+
+static bool checkKnown(const char* digits, int radix, const char* binary) {
+    BigNum n;
+    bignumInit(&n);
+    char out[BITVEC_MAX_BITS + 2];
+    bool ok = bignumParse(&n, digits, strlen(digits), radix) &&
+              bignumFormatBinary(&n, out, sizeof(out)) < sizeof(out) && strcmp(out, binary) == 0;
+    if (!ok) {
+        printf("bignum check failed: %s in radix %d\n", digits, radix);
+    }
+    bignumFree(&n);
+    return ok;
+}
+
+// Binary string of ones 1s followed by zeros 0s
+static const char* bitPattern(char* out, int ones, int zeros) {
+    memset(out, '1', (size_t)ones);
+    memset(out + ones, '0', (size_t)zeros);
+    out[ones + zeros] = '\0';
+    return out;
+}
+
+// All top digits, a power of the radix and random digits (in either letter
+// case), each length digits long
+static int checkLength(char* digits, size_t length, int radix, uint64_t* state) {
+    static const char upper[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    static const char lower[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+    int failures = 0;
+    memset(digits, upper[radix - 1], length);
+    digits[length] = '\0';
+    failures += !checkDigits(digits, radix, "all top digits");
+
+    memset(digits, '0', length);
+    digits[0] = '1';
+    failures += !checkDigits(digits, radix, "a power of the radix");
+
+    for (size_t i = 0; i < length; i++) {
+        *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+        int value = (int)((*state >> 33) % (uint64_t)radix);
+        digits[i] = (*state >> 32) & 1 ? lower[value] : upper[value];
+    }
+    failures += !checkDigits(digits, radix, "random digits");
+    return failures;
+}
+
+int bignumSelfTest(void) {
+    static const int radixes[3] = {8, 10, 16};
+    // Digit counts either side of a limb, a decimal chunk, the bit-vector
+    // limit, the schoolbook cut-off and the Karatsuba threshold (in limbs)
+    static const size_t lengths[] = {1, 15, 16, 17, 19, 20, 21, 22, 23, 38, 39, 42, 43, 63, 64, 65, 77,
+                                     78, 79, 85, 86, 87, 607, 608, 609, 1216, 1217, 2432, 4000, 9000};
+    int failures = 0;
+    char bits[BITVEC_MAX_BITS + 2];
+
+    // Values pinned independently of either parser
+    failures += !checkKnown("18446744073709551615", 10, bitPattern(bits, 64, 0));
+    failures += !checkKnown("18446744073709551616", 10, bitPattern(bits, 1, 64));
+    failures += !checkKnown("10000000000000000000", 10, "1000101011000111001000110000010010001001111010000000000000000000");
+    failures += !checkKnown("1777777777777777777777", 8, bitPattern(bits, 64, 0));
+    failures += !checkKnown("FFFFFFFFFFFFFFFF", 16, bitPattern(bits, 64, 0));
+    failures += !checkKnown("10000000000000000", 16, bitPattern(bits, 1, 64));
+    failures += !checkKnown("115792089237316195423570985008687907853269984665640564039457584007913129639935",
+                            10, bitPattern(bits, BITVEC_MAX_BITS, 0));
+    failures += !checkKnown("0000", 10, "0");
+
+    size_t maxLength = 9000;
+    char* digits = malloc(maxLength + 1);
+    if (!digits) return failures + 1;
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    for (int r = 0; r < 3; r++) {
+        int radix = radixes[r];
+        for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+            failures += checkLength(digits, lengths[l], radix, &state);
+        }
+    }
+
+    // Every radix from 2 to 36, either side of one chunk and of the
+    // schoolbook cut-off, and long enough for Karatsuba
+    static const size_t chunkCounts[] = {1, SCHOOLBOOK_CHUNKS, SCHOOLBOOK_CHUNKS + 1, 130};
+    for (int radix = 2; radix <= 36; radix++) {
+        size_t chunkDigits = (size_t)radixChunkDigits(radix);
+        for (size_t c = 0; c < sizeof(chunkCounts) / sizeof(chunkCounts[0]); c++) {
+            size_t length = chunkCounts[c] * chunkDigits;
+            if (length > maxLength - 1) length = maxLength - 1;
+            failures += checkLength(digits, length - (length > 1), radix, &state);
+            failures += checkLength(digits, length, radix, &state);
+            failures += checkLength(digits, length + 1, radix, &state);
+        }
+    }
+
+    // The largest value that fits a bit-vector, and one past it
+    int octalDigits = (BITVEC_MAX_BITS + 2) / 3;
+    memset(digits, '7', (size_t)octalDigits);
+    digits[0] = "713"[BITVEC_MAX_BITS % 3];
+    digits[octalDigits] = '\0';
+    failures += !checkDigits(digits, 8, "the bit-vector maximum");
+    octalDigits = BITVEC_MAX_BITS / 3 + 1;
+    memset(digits, '0', (size_t)octalDigits);
+    digits[0] = "124"[BITVEC_MAX_BITS % 3];
+    digits[octalDigits] = '\0';
+    failures += !checkDigits(digits, 8, "one past the bit-vector maximum");
+    memset(digits, '0', BITVEC_MAX_BITS / 4 + 1);
+    digits[0] = '1';
+    digits[BITVEC_MAX_BITS / 4 + 1] = '\0';
+    failures += !checkDigits(digits, 16, "one past the bit-vector maximum");
+    failures += !checkDigits("115792089237316195423570985008687907853269984665640564039457584007913129639935",
+                             10, "the bit-vector maximum");
+    failures += !checkDigits("115792089237316195423570985008687907853269984665640564039457584007913129639936",
+                             10, "one past the bit-vector maximum");
+    free(digits);
+    return failures;
+}
@@ -0,0 +1,43 @@
+#ifndef BIGNUM_H
+#define BIGNUM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "binary.h"
+
+// Arbitrary-precision unsigned integer for digit strings wider than an int.
+// Limbs are little-endian 64-bit words; count never includes leading zero limbs.
+typedef struct {
+    uint64_t* limbs;
+    size_t count;
+    size_t capacity;
+} BigNum;
+
+void bignumInit(BigNum* n);
+void bignumFree(BigNum* n);
+
+// Parse digits in any radix from 2 to 36 (no prefix, no sign; letters in
+// either case). Power-of-two radices are packed straight into limbs in linear
+// time; the others are split recursively and recombined with precomputed
+// powers of the chunk base (divide-and-conquer).
+bool bignumParse(BigNum* n, const char* digits, size_t length, int radix);
+bool bignumParseType(BigNum* n, const char* digits, size_t length, ConversionType type);
+
+size_t bignumBitLength(const BigNum* n);
+bool bignumToBitVector(const BigNum* n, BitVector* out);
+
+// Writes the binary digits ("0" for zero); returns the number of characters
+// the full string needs, like snprintf
+size_t bignumFormatBinary(const BigNum* n, char* out, size_t outSize);
+
+// Convenience: digit string straight into a bit-vector; false if the input
+// is malformed or wider than BITVEC_MAX_BITS
+bool convertDigitsToBinary(const char* digits, ConversionType type, BitVector* out);
+
+// Checks the parsers against a digit-at-a-time reference and known values,
+// across limb and chunk boundaries, the Karatsuba threshold and
+// BITVEC_MAX_BITS, in all three radixes. Prints each failure; returns the count.
+int bignumSelfTest(void);
+
+#endif
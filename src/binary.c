@@ -1,72 +1,243 @@
+#define _POSIX_C_SOURCE 199309L
 #include "binary.h"
+#include <time.h>
+#ifdef _WIN32
+#include <windows.h>
+#endif
 
-// Convert decimal to binary
-int binaryConvert(int number,int *bits,int maxBits){
-    int count=0;
-    if(number==0){
-        bits[0]=0;
-        return 1;
-    }
-    while (number>0 && count<maxBits )
-    {
-        bits[count++]=number%2;
-        number/=2;
-    }
-    //reverse bits for correct order
-    for (int i=0;i<count/2;i++){
-        int temp=bits[i];
-        bits[i]=bits[count-i-1];
-        bits[count-i-1]=temp;
+// Elements converted per kernel pass; sized so the scratch values stay in L1
+#define BATCH_BLOCK 256
+
+// Number of significant bits in value (0 for 0), using count-leading-zeros
+int bitLength64(uint64_t value) {
+    if (value == 0) {
+        return 0;
     }
+#if defined(__GNUC__) || defined(__clang__)
+    return 64 - __builtin_clzll(value);
+#else
+    int length = 0;
+    while (value) {
+        length++;
+        value >>= 1;
+    }
+    return length;
+#endif
+}
+
+void bitvecClear(BitVector* v) {
+    for (int i = 0; i < BITVEC_WORDS; i++) {
+        v->words[i] = 0;
+    }
+    v->length = 0;
+}
+
+// Zero is stored as a single 0 bit so there is always something to collect
+void bitvecFromUint(BitVector* v, uint64_t value) {
+    bitvecClear(v);
+    v->words[0] = value;
+    v->length = value ? bitLength64(value) : 1;
+}
+
+// Bit at position index, counted from the most significant bit
+int bitvecGet(const BitVector* v, int index) {
+    int pos = v->length - 1 - index;
+    if (index < 0 || pos < 0) {
+        return 0;
+    }
+    return (int)((v->words[pos / BITVEC_WORD_BITS] >> (pos % BITVEC_WORD_BITS)) & 1u);
+}
+
+// Append a bit at the least significant end (collection order)
+bool bitvecAppend(BitVector* v, int bit) {
+    if (v->length >= BITVEC_MAX_BITS) {
+        return false;
+    }
+    for (int i = BITVEC_WORDS - 1; i > 0; i--) {
+        v->words[i] = (v->words[i] << 1) | (v->words[i - 1] >> (BITVEC_WORD_BITS - 1));
+    }
+    v->words[0] = (v->words[0] << 1) | (uint64_t)(bit & 1);
+    v->length++;
+    return true;
+}
+
+bool bitvecEqual(const BitVector* a, const BitVector* b) {
+    if (a->length != b->length) {
+        return false;
+    }
+    for (int i = 0; i < BITVEC_WORDS; i++) {
+        if (a->words[i] != b->words[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// True if prefix matches the leading (most significant) bits of v
+bool bitvecIsPrefix(const BitVector* prefix, const BitVector* v) {
+    if (prefix->length > v->length) {
+        return false;
+    }
+    int shift = v->length - prefix->length;
+    int wordShift = shift / BITVEC_WORD_BITS;
+    int bitShift = shift % BITVEC_WORD_BITS;
+
+    // Compare prefix against v shifted right, one word at a time
+    for (int i = 0; i < BITVEC_WORDS; i++) {
+        uint64_t shifted = 0;
+        if (i + wordShift < BITVEC_WORDS) {
+            shifted = v->words[i + wordShift] >> bitShift;
+            if (bitShift && i + wordShift + 1 < BITVEC_WORDS) {
+                shifted |= v->words[i + wordShift + 1] << (BITVEC_WORD_BITS - bitShift);
+            }
+        }
+        if (shifted != prefix->words[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Write the bits as a '0'/'1' string; returns the number of characters written
+int bitvecFormat(const BitVector* v, char* out, int outSize) {
+    int count = 0;
+    if (outSize <= 0) {
+        return 0;
+    }
+    while (count < v->length && count < outSize - 1) {
+        out[count] = bitvecGet(v, count) ? '1' : '0';
+        count++;
+    }
+    out[count] = '\0';
     return count;
 }
 
+// Convert decimal to binary
+int decimalToBinary(int number, BitVector* out) {
+    bitvecFromUint(out, number > 0 ? (uint64_t)number : 0);
+    return out->length;
+}
+
+// Decode an octal number written with decimal digits (e.g. 17 -> 15).
+// Branchless and fixed-trip so the batch loop below auto-vectorizes;
+// any digit 8 or 9 makes the whole number invalid and decodes to 0.
+static inline uint64_t decodeOctalDigits(int number) {
+    uint32_t n = number > 0 ? (uint32_t)number : 0;
+    uint64_t value = 0;
+    uint32_t invalid = 0;
+
+    // An int has at most 10 decimal digits, each octal digit maps to 3 bits
+    for (int d = 0; d < 10; d++) {
+        uint32_t digit = n % 10;
+        n /= 10;
+        invalid |= digit >> 3;
+        value |= (uint64_t)digit << (3 * d);
+    }
+    return invalid ? 0 : value;
+}
+
 // Convert octal to binary (octal number is given as decimal representation of octal)
 // For example: 17 (octal) = 15 (decimal) = 1111 (binary)
-int octalToBinary(int octalNumber, int* bits, int maxBits) {
-    // Handle zero case
-    if (octalNumber == 0) {
-        bits[0] = 0;
-        return 1;
-    }
-    
-    // First convert octal to decimal
-    int decimal = 0;
-    int base = 1;
-    
-    while (octalNumber > 0) {
-        int digit = octalNumber % 10;
-        if (digit >= 8) {
-            // Invalid octal digit - treat as 0
-            bits[0] = 0;
-            return 1;
-        }
-        decimal += digit * base;
-        base *= 8;
-        octalNumber /= 10;
-    }
-    
-    // Then convert decimal to binary
-    return binaryConvert(decimal, bits, maxBits);
+int octalToBinary(int octalNumber, BitVector* out) {
+    bitvecFromUint(out, decodeOctalDigits(octalNumber));
+    return out->length;
 }
 
 // Convert hexadecimal to binary (hex number is given as integer value)
 // For example: 0x1F = 31 (decimal) = 11111 (binary)
-int hexToBinary(int hexNumber, int* bits, int maxBits) {
+int hexToBinary(int hexNumber, BitVector* out) {
     // Hex number is already in decimal form, just convert to binary
-    return binaryConvert(hexNumber, bits, maxBits);
+    return decimalToBinary(hexNumber, out);
 }
 
 // Universal conversion function
-int convertToBinary(int number, int* bits, int maxBits, ConversionType type) {
+int convertToBinary(int number, BitVector* out, ConversionType type) {
     switch (type) {
         case CONVERSION_DECIMAL:
-            return binaryConvert(number, bits, maxBits);
+            return decimalToBinary(number, out);
         case CONVERSION_OCTAL:
-            return octalToBinary(number, bits, maxBits);
+            return octalToBinary(number, out);
         case CONVERSION_HEXADECIMAL:
-            return hexToBinary(number, bits, maxBits);
+            return hexToBinary(number, out);
         default:
-            return binaryConvert(number, bits, maxBits);
+            return decimalToBinary(number, out);
     }
-}
\ No newline at end of file
+}
+
+static double batchClock(void) {
+#ifdef _WIN32
+    LARGE_INTEGER counter, frequency;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+#endif
+}
+
+// Per-type value kernels: plain loops over contiguous arrays with no
+// early exits, so the compiler can vectorize them
+static void decimalKernel(const int* restrict numbers, uint64_t* restrict values, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        values[i] = numbers[i] > 0 ? (uint64_t)numbers[i] : 0;
+    }
+}
+
+static void octalKernel(const int* restrict numbers, uint64_t* restrict values, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        values[i] = decodeOctalDigits(numbers[i]);
+    }
+}
+
+// Packs a block of decoded values into bit-vectors
+static void packKernel(const uint64_t* restrict values, BitVector* restrict out, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        int length = bitLength64(values[i]);
+        for (int w = 0; w < BITVEC_WORDS; w++) {
+            out[i].words[w] = 0;
+        }
+        out[i].words[0] = values[i];
+        out[i].length = length ? length : 1;
+    }
+}
+
+// Convert count numbers into out[0..count); stats may be NULL
+void convertBatch(const int* numbers, BitVector* out, size_t count,
+                  ConversionType type, BatchStats* stats) {
+    uint64_t values[BATCH_BLOCK];
+    double start = stats ? batchClock() : 0.0;
+
+    for (size_t base = 0; base < count; base += BATCH_BLOCK) {
+        size_t n = count - base < BATCH_BLOCK ? count - base : BATCH_BLOCK;
+        switch (type) {
+            case CONVERSION_OCTAL:
+                octalKernel(numbers + base, values, n);
+                break;
+            case CONVERSION_DECIMAL:
+            case CONVERSION_HEXADECIMAL: // hex input is already the integer value
+            default:
+                decimalKernel(numbers + base, values, n);
+                break;
+        }
+        packKernel(values, out + base, n);
+    }
+
+    if (stats) {
+        stats->count = count;
+        stats->seconds = batchClock() - start;
+        stats->elementsPerSecond = stats->seconds > 0.0 ? count / stats->seconds : 0.0;
+    }
+}
+
+// Convert decimal to binary, one int per bit (most significant first)
+int binaryConvert(int number,int *bits,int maxBits){
+    BitVector v;
+    decimalToBinary(number,&v);
+    int count=v.length<maxBits?v.length:maxBits;
+    for (int i=0;i<count;i++){
+        bits[i]=bitvecGet(&v,i);
+    }
+    return count;
+}
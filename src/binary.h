@@ -1,6 +1,10 @@
 #ifndef BINARY_H
 #define BINARY_H
 
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
 // Conversion types
 typedef enum {
     CONVERSION_DECIMAL,
@@ -8,9 +12,61 @@ typedef enum {
     CONVERSION_HEXADECIMAL
 } ConversionType;
 
+// Packed bit-vector: bits are stored in 64-bit words (words[0] holds the
+// least significant bits) and read back most-significant-first, which is the
+// order the player has to collect them in.
+#define BITVEC_WORD_BITS 64
+#define BITVEC_MAX_BITS 256
+#define BITVEC_WORDS ((BITVEC_MAX_BITS + BITVEC_WORD_BITS - 1) / BITVEC_WORD_BITS)
+
+typedef struct {
+    uint64_t words[BITVEC_WORDS];
+    int length; // number of significant bits
+} BitVector;
+
+// 64x64 -> 128-bit multiply; returns the low word and stores the high word
+static inline uint64_t mulWide64(uint64_t a, uint64_t b, uint64_t* hi) {
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 product = (unsigned __int128)a * b;
+    *hi = (uint64_t)(product >> 64);
+    return (uint64_t)product;
+#else
+    uint64_t aLo = a & 0xFFFFFFFFu, aHi = a >> 32;
+    uint64_t bLo = b & 0xFFFFFFFFu, bHi = b >> 32;
+    uint64_t ll = aLo * bLo, lh = aLo * bHi, hl = aHi * bLo, hh = aHi * bHi;
+    uint64_t mid = (ll >> 32) + (lh & 0xFFFFFFFFu) + (hl & 0xFFFFFFFFu);
+    *hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+    return (mid << 32) | (ll & 0xFFFFFFFFu);
+#endif
+}
+
+// Bit-vector helpers
+int bitLength64(uint64_t value);
+void bitvecClear(BitVector* v);
+void bitvecFromUint(BitVector* v, uint64_t value);
+int bitvecGet(const BitVector* v, int index);
+bool bitvecAppend(BitVector* v, int bit);
+bool bitvecEqual(const BitVector* a, const BitVector* b);
+bool bitvecIsPrefix(const BitVector* prefix, const BitVector* v);
+int bitvecFormat(const BitVector* v, char* out, int outSize);
+
+// Conversions into a packed bit-vector; each returns the bit length
+int decimalToBinary(int number, BitVector* out);
+int octalToBinary(int octalNumber, BitVector* out);
+int hexToBinary(int hexNumber, BitVector* out);
+int convertToBinary(int number, BitVector* out, ConversionType type);
+
+// Batch conversion of whole arrays into packed outputs
+typedef struct {
+    size_t count;             // elements converted
+    double seconds;           // wall time spent in the kernels
+    double elementsPerSecond; // throughput of the call
+} BatchStats;
+
+void convertBatch(const int* numbers, BitVector* out, size_t count,
+                  ConversionType type, BatchStats* stats);
+
+// Unpacks a decimal conversion into one int per bit (console version)
 int binaryConvert(int number, int* bits, int maxBits);
-int octalToBinary(int octalNumber, int* bits, int maxBits);
-int hexToBinary(int hexNumber, int* bits, int maxBits);
-int convertToBinary(int number, int* bits, int maxBits, ConversionType type);
 
 #endif
@@ -0,0 +1,67 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "binary.h"
+
+// Throughput benchmark for convertBatch
+// Usage: bqbench [count] [rounds]
+
+static const char* typeName(ConversionType type) {
+    switch (type) {
+        case CONVERSION_DECIMAL: return "decimal";
+        case CONVERSION_OCTAL: return "octal";
+        case CONVERSION_HEXADECIMAL: return "hexadecimal";
+    }
+    return "unknown";
+}
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? (size_t)strtoull(argv[1], NULL, 10) : 1000000;
+    int rounds = argc > 2 ? atoi(argv[2]) : 5;
+    if (count == 0 || rounds <= 0) {
+        printf("Usage: %s [count] [rounds]\n", argv[0]);
+        return 1;
+    }
+
+    int* numbers = malloc(count * sizeof(int));
+    BitVector* out = malloc(count * sizeof(BitVector));
+    if (!numbers || !out) {
+        printf("Could not allocate %zu elements\n", count);
+        free(numbers);
+        free(out);
+        return 1;
+    }
+
+    for (ConversionType type = CONVERSION_DECIMAL; type <= CONVERSION_HEXADECIMAL; type++) {
+        // Octal inputs are written with decimal digits, so build them digit by digit
+        srand(1234);
+        for (size_t i = 0; i < count; i++) {
+            if (type == CONVERSION_OCTAL) {
+                int value = 0;
+                for (int d = 0; d < 9; d++) {
+                    value = value * 10 + rand() % 8;
+                }
+                numbers[i] = value;
+            } else {
+                numbers[i] = rand();
+            }
+        }
+
+        double best = 0.0;
+        unsigned long long checksum = 0;
+        for (int r = 0; r < rounds; r++) {
+            BatchStats stats;
+            convertBatch(numbers, out, count, type, &stats);
+            if (stats.elementsPerSecond > best) {
+                best = stats.elementsPerSecond;
+            }
+            checksum += out[count / 2].words[0] + out[count - 1].length;
+        }
+
+        printf("%-12s %10zu elements  %8.1f M elements/s  (checksum %llu)\n",
+               typeName(type), count, best / 1e6, checksum);
+    }
+
+    free(numbers);
+    free(out);
+    return 0;
+}
@@ -0,0 +1,154 @@
+#include "bot.h"
+#include <math.h>
+
+#define BOT_DEADBAND 2.0f        // pixels; closer than this counts as lined up
+#define BOT_DANGER_HORIZON 1.0f  // seconds ahead to look for wrong bits
+#define BOT_REACH_OVERLAP 0.8f   // fraction of the catch overlap the bot relies on
+
+typedef struct {
+    float x;        // player x now
+    float minX;
+    float maxX;
+    float speed;    // pixels per second
+    float width;
+    float catchTop; // top of the player, where bits start to count
+} BotView;
+
+static float clampX(const BotView* view, float x) {
+    if (x < view->minX) return view->minX;
+    if (x > view->maxX) return view->maxX;
+    return x;
+}
+
+// Seconds until bit i reaches the catch band (0 once it is in it)
+static float arrivalTime(const GameState* game, const BotView* view, int i) {
+    const BitPool* bits = &game->fallingBits;
+    float gap = view->catchTop - (bits->y[i] + BIT_SIZE);
+    float fallSpeed = bits->speed[i] * game->gameSpeed;
+    if (gap <= 0.0f || fallSpeed <= 0.0f) return 0.0f;
+    return gap / fallSpeed;
+}
+
+// Player x after t seconds of holding direction, stopping at stopX when
+// heading toward it
+static float predictX(const BotView* view, int direction, float t, bool stops, float stopX) {
+    float x = view->x + direction * view->speed * t;
+    if (stops && ((direction > 0 && x > stopX) || (direction < 0 && x < stopX))) {
+        x = stopX;
+    }
+    return clampX(view, x);
+}
+
+static bool overlapsBit(const BotView* view, float playerX, float bitX) {
+    return bitX < playerX + view->width && bitX + BIT_SIZE > playerX;
+}
+
+// Wrong bits this direction would run into, checked where the player will
+// be when each one enters and leaves the catch band
+static int countDangers(const GameState* game, const BotView* view, int direction,
+                        bool stops, float stopX) {
+    const BitPool* bits = &game->fallingBits;
+    float bottom = GAME_AREA_Y + GAME_AREA_HEIGHT;
+    int dangers = 0;
+    for (int i = 0; i < bits->count; i++) {
+        if (bits->y[i] > bottom || isCorrectBit(game, bits->value[i])) continue;
+        float enter = arrivalTime(game, view, i);
+        if (enter > BOT_DANGER_HORIZON) continue;
+        float fallSpeed = bits->speed[i] * game->gameSpeed;
+        float leave = fallSpeed > 0.0f
+            ? (bottom - bits->y[i]) / fallSpeed
+            : enter;
+        if (overlapsBit(view, predictX(view, direction, enter, stops, stopX), bits->x[i]) ||
+            overlapsBit(view, predictX(view, direction, leave, stops, stopX), bits->x[i])) {
+            dangers++;
+        }
+    }
+    return dangers;
+}
+
+// Keep going the same way, turning around at the walls
+static int sweepDirection(const Bot* bot, const GameState* game) {
+    float x = game->player.x;
+    if (x <= GAME_AREA_X) return 1;
+    if (x >= GAME_AREA_X + GAME_AREA_WIDTH - game->player.width) return -1;
+    return bot->held != 0 ? bot->held : 1;
+}
+
+static int autoplayDirection(const GameState* game) {
+    const Player* player = &game->player;
+    BotView view;
+    view.x = player->x;
+    view.minX = GAME_AREA_X;
+    view.maxX = GAME_AREA_X + GAME_AREA_WIDTH - player->width;
+    view.speed = player->speed * (player->hasSpeedBoost ? 1.5f : 1.0f);
+    view.width = player->width;
+    view.catchTop = GAME_AREA_Y + GAME_AREA_HEIGHT - PLAYER_HEIGHT;
+
+    // Target: the soonest correct bit the player can still get under
+    const BitPool* bits = &game->fallingBits;
+    float bottom = GAME_AREA_Y + GAME_AREA_HEIGHT;
+    float slack = (view.width + BIT_SIZE) * 0.5f * BOT_REACH_OVERLAP;
+    float targetX = (view.minX + view.maxX) * 0.5f; // idle in the middle
+    float bestTime = INFINITY;
+    for (int i = 0; i < bits->count; i++) {
+        if (bits->y[i] > bottom || !isCorrectBit(game, bits->value[i])) continue;
+        float t = arrivalTime(game, &view, i);
+        float x = clampX(&view, bits->x[i] + BIT_SIZE * 0.5f - view.width * 0.5f);
+        if (fabsf(x - view.x) - slack > view.speed * t) continue;
+        if (t < bestTime) {
+            bestTime = t;
+            targetX = x;
+        }
+    }
+
+    int desired = 0;
+    if (targetX > view.x + BOT_DEADBAND) desired = 1;
+    else if (targetX < view.x - BOT_DEADBAND) desired = -1;
+
+    // Prefer the desired move, then standing still, then backing off
+    int candidates[4] = {desired, 0, -1, 1};
+    int best = desired;
+    int fewest = -1;
+    for (int c = 0; c < 4; c++) {
+        int direction = candidates[c];
+        bool stops = direction == desired;
+        int dangers = countDangers(game, &view, direction, stops, targetX);
+        if (dangers == 0) return direction;
+        if (fewest < 0 || dangers < fewest) {
+            fewest = dangers;
+            best = direction;
+        }
+    }
+    return best;
+}
+
+int botChooseDirection(const Bot* bot, const GameState* game) {
+    return bot->model == BOT_SWEEP ? sweepDirection(bot, game) : autoplayDirection(game);
+}
+
+int botInputs(Bot* bot, const GameState* game, SimInput inputs[2]) {
+    int direction = botChooseDirection(bot, game);
+    if (direction == bot->held) return 0;
+
+    int count = 0;
+    if (bot->held != 0) {
+        inputs[count++] = bot->held < 0 ? SIM_INPUT_LEFT_RELEASE : SIM_INPUT_RIGHT_RELEASE;
+    }
+    if (direction != 0) {
+        inputs[count++] = direction < 0 ? SIM_INPUT_LEFT_PRESS : SIM_INPUT_RIGHT_PRESS;
+    }
+    bot->held = direction;
+    return count;
+}
+
+void botPlay(Bot* bot, GameState* game, uint32_t maxTicks) {
+    while (!game->gameOver && game->tick < maxTicks) {
+        SimInput inputs[2];
+        int count = botInputs(bot, game, inputs);
+        for (int i = 0; i < count; i++) {
+            simApplyInput(game, inputs[i]);
+        }
+        updateGame(game, SIM_TICK_SECONDS);
+        simClearEvents(game);
+    }
+}
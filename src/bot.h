@@ -0,0 +1,32 @@
+#ifndef BOT_H
+#define BOT_H
+
+#include "sim.h"
+
+// Scripted players. The autoplay model steers toward the falling bit that
+// extends the answer and arrives soonest while still reachable, and holds
+// still or backs off when its path would take a wrong bit; the sweep model
+// just runs from wall to wall. Bots only read the GameState and talk to
+// the game through SimInputs, like a player at the keyboard.
+
+typedef enum {
+    BOT_AUTOPLAY,
+    BOT_SWEEP
+} BotModel;
+
+typedef struct {
+    BotModel model;
+    int held; // direction of the movement key currently down, 0 for none
+} Bot;
+
+// Direction the bot wants this tick: -1, 0 or 1
+int botChooseDirection(const Bot* bot, const GameState* game);
+
+// Inputs (at most two) that switch the held key to the chosen direction;
+// apply them in order before the next updateGame
+int botInputs(Bot* bot, const GameState* game, SimInput inputs[2]);
+
+// Play fixed SIM_TICK_SECONDS ticks until game over or maxTicks
+void botPlay(Bot* bot, GameState* game, uint32_t maxTicks);
+
+#endif
@@ -0,0 +1,485 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "binary.h"
+#include "bignum.h"
+
+// Bulk converter: newline-separated numbers in, binary strings out.
+// The input is cut into chunks on line boundaries, chunks are converted on
+// worker threads and written back in input order. At most SLOTS_PER_THREAD
+// chunks per worker are in flight, which bounds memory on any input size.
+
+#define DEFAULT_CHUNK_SIZE (1 << 20)
+#define SLOTS_PER_THREAD 2
+#define LINE_BATCH 256
+
+typedef enum {
+    SLOT_EMPTY,
+    SLOT_READY,   // filled by the reader, waiting for a worker
+    SLOT_WORKING,
+    SLOT_DONE     // converted, waiting for the writer
+} SlotState;
+
+typedef struct {
+    SlotState state;
+    size_t sequence;
+    const char* input;  // chunk text (points into the map or into buffer)
+    size_t inputLength;
+    char* buffer;       // owned input storage when reading from a pipe
+    size_t bufferCapacity;
+    char* output;
+    size_t outputLength;
+    size_t outputCapacity;
+    size_t invalidLines;
+} Slot;
+
+typedef struct {
+    Slot* slots;
+    int slotCount;
+    size_t nextToConvert; // sequence the next idle worker takes
+    size_t nextToWrite;
+    size_t chunksRead;
+    bool inputDone;
+    bool failed;
+    ConversionType type;
+    int outFd;
+    size_t invalidLines;
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+} Converter;
+
+// Batch of short lines waiting for convertBatch
+typedef struct {
+    int numbers[LINE_BATCH];
+    BitVector bits[LINE_BATCH];
+    int count;
+} LineBatch;
+
+static bool ensureOutput(Slot* slot, size_t extra) {
+    size_t needed = slot->outputLength + extra;
+    if (needed <= slot->outputCapacity) {
+        return true;
+    }
+    size_t capacity = slot->outputCapacity ? slot->outputCapacity : 4096;
+    while (capacity < needed) {
+        capacity *= 2;
+    }
+    char* output = realloc(slot->output, capacity);
+    if (!output) {
+        return false;
+    }
+    slot->output = output;
+    slot->outputCapacity = capacity;
+    return true;
+}
+
+static bool flushBatch(Slot* slot, LineBatch* batch, ConversionType type) {
+    convertBatch(batch->numbers, batch->bits, batch->count, type, NULL);
+    for (int i = 0; i < batch->count; i++) {
+        const BitVector* v = &batch->bits[i];
+        if (!ensureOutput(slot, v->length + 1)) {
+            return false;
+        }
+        char* out = slot->output + slot->outputLength;
+        uint64_t word = v->words[0];
+        for (int b = v->length - 1; b >= 0; b--) {
+            *out++ = (char)('0' + ((word >> b) & 1u));
+        }
+        *out = '\n';
+        slot->outputLength += v->length + 1;
+    }
+    batch->count = 0;
+    return true;
+}
+
+// Parse a line that fits the int kernels; false means it needs the bignum path
+static bool parseShortLine(const char* text, size_t length, ConversionType type, int* number, bool* invalid) {
+    *invalid = false;
+    int value = 0;
+    switch (type) {
+        case CONVERSION_HEXADECIMAL:
+            if (length > 7) return false;
+            for (size_t i = 0; i < length; i++) {
+                char c = text[i];
+                int digit;
+                if (c >= '0' && c <= '9') digit = c - '0';
+                else if (c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+                else if (c >= 'A' && c <= 'F') digit = c - 'A' + 10;
+                else { *invalid = true; return true; }
+                value = value * 16 + digit;
+            }
+            break;
+        case CONVERSION_OCTAL:
+        case CONVERSION_DECIMAL:
+        default:
+            // Octal stays in its decimal-digit spelling; the kernel decodes it
+            if (length > 9) return false;
+            for (size_t i = 0; i < length; i++) {
+                char c = text[i];
+                char maxDigit = type == CONVERSION_OCTAL ? '7' : '9';
+                if (c < '0' || c > maxDigit) { *invalid = true; return true; }
+                value = value * 10 + (c - '0');
+            }
+            break;
+    }
+    *number = value;
+    return true;
+}
+
+static bool convertLongLine(Slot* slot, const char* text, size_t length, ConversionType type, BigNum* n) {
+    if (!bignumParseType(n, text, length, type)) {
+        slot->invalidLines++;
+        if (!ensureOutput(slot, 1)) {
+            return false;
+        }
+        slot->output[slot->outputLength++] = '\n';
+        return true;
+    }
+    size_t bits = bignumBitLength(n);
+    if (!ensureOutput(slot, (bits ? bits : 1) + 2)) {
+        return false;
+    }
+    slot->outputLength += bignumFormatBinary(n, slot->output + slot->outputLength,
+                                             slot->outputCapacity - slot->outputLength);
+    slot->output[slot->outputLength++] = '\n';
+    return true;
+}
+
+// Convert every line of a chunk, keeping line order
+static bool convertChunk(Slot* slot, ConversionType type) {
+    LineBatch batch;
+    BigNum n;
+    bool ok = true;
+    batch.count = 0;
+    bignumInit(&n);
+    slot->outputLength = 0;
+    slot->invalidLines = 0;
+
+    const char* p = slot->input;
+    const char* end = slot->input + slot->inputLength;
+    while (ok && p < end) {
+        const char* lineEnd = memchr(p, '\n', end - p);
+        if (!lineEnd) lineEnd = end;
+        const char* start = p;
+        const char* stop = lineEnd;
+        while (start < stop && (*start == ' ' || *start == '\t')) start++;
+        while (stop > start && (stop[-1] == '\r' || stop[-1] == ' ' || stop[-1] == '\t')) stop--;
+        p = lineEnd + 1;
+
+        size_t length = stop - start;
+        int number;
+        bool invalid;
+        if (length == 0) {
+            ok = flushBatch(slot, &batch, type) && ensureOutput(slot, 1);
+            if (ok) slot->output[slot->outputLength++] = '\n';
+        } else if (parseShortLine(start, length, type, &number, &invalid)) {
+            if (invalid) {
+                slot->invalidLines++;
+                ok = flushBatch(slot, &batch, type) && ensureOutput(slot, 1);
+                if (ok) slot->output[slot->outputLength++] = '\n';
+            } else {
+                batch.numbers[batch.count++] = number;
+                if (batch.count == LINE_BATCH) {
+                    ok = flushBatch(slot, &batch, type);
+                }
+            }
+        } else {
+            ok = flushBatch(slot, &batch, type) && convertLongLine(slot, start, length, type, &n);
+        }
+    }
+    if (ok) {
+        ok = flushBatch(slot, &batch, type);
+    }
+    bignumFree(&n);
+    return ok;
+}
+
+static void* workerMain(void* arg) {
+    Converter* conv = arg;
+    pthread_mutex_lock(&conv->lock);
+    for (;;) {
+        Slot* slot = NULL;
+        while (!conv->failed) {
+            if (conv->nextToConvert < conv->chunksRead) {
+                slot = &conv->slots[conv->nextToConvert % conv->slotCount];
+                if (slot->state == SLOT_READY) break;
+                slot = NULL;
+            } else if (conv->inputDone) {
+                break;
+            }
+            pthread_cond_wait(&conv->changed, &conv->lock);
+        }
+        if (!slot) break;
+
+        conv->nextToConvert++;
+        slot->state = SLOT_WORKING;
+        pthread_mutex_unlock(&conv->lock);
+        bool ok = convertChunk(slot, conv->type);
+        pthread_mutex_lock(&conv->lock);
+        slot->state = SLOT_DONE;
+        if (!ok) conv->failed = true;
+        pthread_cond_broadcast(&conv->changed);
+    }
+    pthread_mutex_unlock(&conv->lock);
+    return NULL;
+}
+
+static bool writeAll(int fd, const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t written = write(fd, data, length);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += written;
+        length -= written;
+    }
+    return true;
+}
+
+static void* writerMain(void* arg) {
+    Converter* conv = arg;
+    pthread_mutex_lock(&conv->lock);
+    for (;;) {
+        Slot* slot = &conv->slots[conv->nextToWrite % conv->slotCount];
+        while (!conv->failed && !(conv->nextToWrite < conv->chunksRead && slot->state == SLOT_DONE) &&
+               !(conv->inputDone && conv->nextToWrite == conv->chunksRead)) {
+            pthread_cond_wait(&conv->changed, &conv->lock);
+        }
+        if (conv->failed || conv->nextToWrite == conv->chunksRead) break;
+
+        pthread_mutex_unlock(&conv->lock);
+        bool ok = writeAll(conv->outFd, slot->output, slot->outputLength);
+        pthread_mutex_lock(&conv->lock);
+        conv->invalidLines += slot->invalidLines;
+        slot->state = SLOT_EMPTY;
+        conv->nextToWrite++;
+        if (!ok) {
+            perror("bqconvert: write");
+            conv->failed = true;
+        }
+        pthread_cond_broadcast(&conv->changed);
+    }
+    pthread_mutex_unlock(&conv->lock);
+    return NULL;
+}
+
+// Wait for the slot the next chunk goes into; NULL once the pipeline failed
+static Slot* acquireSlot(Converter* conv) {
+    pthread_mutex_lock(&conv->lock);
+    Slot* slot = &conv->slots[conv->chunksRead % conv->slotCount];
+    while (!conv->failed && slot->state != SLOT_EMPTY) {
+        pthread_cond_wait(&conv->changed, &conv->lock);
+    }
+    if (conv->failed) slot = NULL;
+    pthread_mutex_unlock(&conv->lock);
+    return slot;
+}
+
+static void publishSlot(Converter* conv, Slot* slot) {
+    pthread_mutex_lock(&conv->lock);
+    slot->sequence = conv->chunksRead++;
+    slot->state = SLOT_READY;
+    pthread_cond_broadcast(&conv->changed);
+    pthread_mutex_unlock(&conv->lock);
+}
+
+// Memory-mapped input: chunks point straight into the mapping
+static bool readMapped(Converter* conv, const char* data, size_t size, size_t chunkSize) {
+    size_t pos = 0;
+    while (pos < size) {
+        size_t end = pos + chunkSize < size ? pos + chunkSize : size;
+        const char* newline = end < size ? memchr(data + end, '\n', size - end) : NULL;
+        end = newline ? (size_t)(newline - data) + 1 : size;
+
+        Slot* slot = acquireSlot(conv);
+        if (!slot) return false;
+        slot->input = data + pos;
+        slot->inputLength = end - pos;
+        publishSlot(conv, slot);
+        pos = end;
+    }
+    return true;
+}
+
+// Pipe input: each slot owns a buffer; a partial last line is carried over
+static bool readStream(Converter* conv, int fd, size_t chunkSize) {
+    char* carry = NULL;
+    size_t carryLength = 0;
+    bool eof = false;
+    bool ok = true;
+
+    while (ok && !eof) {
+        Slot* slot = acquireSlot(conv);
+        if (!slot) { ok = false; break; }
+        if (slot->bufferCapacity < chunkSize + carryLength) {
+            char* buffer = realloc(slot->buffer, chunkSize + carryLength);
+            if (!buffer) { ok = false; break; }
+            slot->buffer = buffer;
+            slot->bufferCapacity = chunkSize + carryLength;
+        }
+        memcpy(slot->buffer, carry, carryLength);
+        size_t length = carryLength;
+
+        // Fill the chunk; keep reading while it holds no complete line
+        for (;;) {
+            while (length < slot->bufferCapacity) {
+                ssize_t got = read(fd, slot->buffer + length, slot->bufferCapacity - length);
+                if (got < 0 && errno == EINTR) continue;
+                if (got <= 0) { eof = true; ok = got == 0; break; }
+                length += got;
+            }
+            if (eof || memchr(slot->buffer + carryLength, '\n', length - carryLength)) {
+                break;
+            }
+            char* buffer = realloc(slot->buffer, slot->bufferCapacity * 2);
+            if (!buffer) { ok = false; break; }
+            slot->buffer = buffer;
+            slot->bufferCapacity *= 2;
+        }
+        if (!ok) break;
+
+        size_t complete = length;
+        if (!eof) {
+            while (complete > 0 && slot->buffer[complete - 1] != '\n') complete--;
+        }
+        carryLength = length - complete;
+        char* newCarry = realloc(carry, carryLength ? carryLength : 1);
+        if (!newCarry) { ok = false; break; }
+        carry = newCarry;
+        memcpy(carry, slot->buffer + complete, carryLength);
+
+        slot->input = slot->buffer;
+        slot->inputLength = complete;
+        publishSlot(conv, slot);
+    }
+    free(carry);
+    return ok;
+}
+
+static void printUsage(const char* program) {
+    printf("Usage: %s [-d|-o|-x] [-t threads] [-c chunk_kb] [file]\n", program);
+    printf("  -d  decimal input (default)\n");
+    printf("  -o  octal input\n");
+    printf("  -x  hexadecimal input\n");
+    printf("  -t  worker threads (default: all cores)\n");
+    printf("  -c  chunk size in KiB (default: %d)\n", DEFAULT_CHUNK_SIZE / 1024);
+    printf("Reads stdin when no file is given. Invalid lines produce empty output lines.\n");
+}
+
+int main(int argc, char* argv[]) {
+    ConversionType type = CONVERSION_DECIMAL;
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t chunkSize = DEFAULT_CHUNK_SIZE;
+    const char* path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-d") == 0) {
+            type = CONVERSION_DECIMAL;
+        } else if (strcmp(argv[i], "-o") == 0) {
+            type = CONVERSION_OCTAL;
+        } else if (strcmp(argv[i], "-x") == 0) {
+            type = CONVERSION_HEXADECIMAL;
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            threads = atol(argv[++i]);
+        } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            chunkSize = (size_t)atol(argv[++i]) * 1024;
+        } else if (argv[i][0] == '-' && argv[i][1] != '\0') {
+            printUsage(argv[0]);
+            return 1;
+        } else {
+            path = argv[i];
+        }
+    }
+    if (threads < 1) threads = 1;
+    if (chunkSize == 0) chunkSize = DEFAULT_CHUNK_SIZE;
+
+    int inFd = STDIN_FILENO;
+    if (path) {
+        inFd = open(path, O_RDONLY);
+        if (inFd < 0) {
+            perror(path);
+            return 1;
+        }
+    }
+
+    // Regular files are mapped; pipes and empty files are streamed
+    struct stat st;
+    char* mapped = NULL;
+    size_t mappedSize = 0;
+    if (fstat(inFd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        mappedSize = (size_t)st.st_size;
+        mapped = mmap(NULL, mappedSize, PROT_READ, MAP_PRIVATE, inFd, 0);
+        if (mapped == MAP_FAILED) {
+            mapped = NULL;
+        } else {
+            posix_madvise(mapped, mappedSize, POSIX_MADV_SEQUENTIAL);
+        }
+    }
+
+    Converter conv;
+    memset(&conv, 0, sizeof(conv));
+    conv.slotCount = (int)threads * SLOTS_PER_THREAD;
+    conv.slots = calloc(conv.slotCount, sizeof(Slot));
+    conv.type = type;
+    conv.outFd = STDOUT_FILENO;
+    pthread_mutex_init(&conv.lock, NULL);
+    pthread_cond_init(&conv.changed, NULL);
+    if (!conv.slots) {
+        printf("bqconvert: out of memory\n");
+        return 1;
+    }
+
+    pthread_t* workers = calloc(threads, sizeof(pthread_t));
+    pthread_t writer;
+    long started = 0;
+    bool ok = workers && pthread_create(&writer, NULL, writerMain, &conv) == 0;
+    bool writerStarted = ok;
+    while (ok && started < threads) {
+        if (pthread_create(&workers[started], NULL, workerMain, &conv) != 0) break;
+        started++;
+    }
+    ok = ok && started > 0;
+
+    if (ok) {
+        ok = mapped ? readMapped(&conv, mapped, mappedSize, chunkSize)
+                    : readStream(&conv, inFd, chunkSize);
+    }
+
+    pthread_mutex_lock(&conv.lock);
+    conv.inputDone = true;
+    if (!ok) conv.failed = true;
+    pthread_cond_broadcast(&conv.changed);
+    pthread_mutex_unlock(&conv.lock);
+
+    for (long i = 0; i < started; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    if (writerStarted) {
+        pthread_join(writer, NULL);
+    }
+    ok = ok && !conv.failed;
+
+    if (conv.invalidLines > 0) {
+        fprintf(stderr, "bqconvert: %zu invalid line(s)\n", conv.invalidLines);
+    }
+
+    for (int i = 0; i < conv.slotCount; i++) {
+        free(conv.slots[i].buffer);
+        free(conv.slots[i].output);
+    }
+    free(conv.slots);
+    free(workers);
+    pthread_mutex_destroy(&conv.lock);
+    pthread_cond_destroy(&conv.changed);
+    if (mapped) munmap(mapped, mappedSize);
+    if (path) close(inFd);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,84 @@
+#include "sim.h"
+#include "alloc.h"
+#include <stdlib.h>
+
+static int columnOf(float x) {
+    int column = (int)((x - GAME_AREA_X) / GRID_CELL_SIZE);
+    if (column < 0) return 0;
+    if (column >= GRID_COLUMNS) return GRID_COLUMNS - 1;
+    return column;
+}
+
+bool broadphaseReserve(Broadphase* grid, int count) {
+    if (count <= grid->capacity) return true;
+    int capacity = grid->capacity > 0 ? grid->capacity : POOL_INITIAL_CAPACITY;
+    while (capacity < count) capacity *= 2;
+
+    int* items = TRACKED_REALLOC(grid->items, (size_t)capacity * sizeof(int));
+    if (!items) return false;
+    grid->items = items;
+    int* expired = TRACKED_REALLOC(grid->expired, (size_t)capacity * sizeof(int));
+    if (!expired) return false;
+    grid->expired = expired;
+    int* column = TRACKED_REALLOC(grid->column, (size_t)capacity * sizeof(int));
+    if (!column) return false;
+    grid->column = column;
+    grid->capacity = capacity;
+    return true;
+}
+
+// Bucket every entity whose box reaches below bandTop by the column of its
+// left edge; entities entirely below floorY go to the expired list instead
+bool broadphaseBuild(Broadphase* grid, const float* x, const float* y, int count,
+                     float size, float bandTop, float floorY) {
+    grid->itemCount = 0;
+    grid->expiredCount = 0;
+    for (int c = 0; c <= GRID_COLUMNS; c++) {
+        grid->columnStart[c] = 0;
+    }
+    if (!broadphaseReserve(grid, count)) return false;
+
+    int counts[GRID_COLUMNS] = {0};
+    for (int i = 0; i < count; i++) {
+        if (y[i] > floorY) {
+            grid->expired[grid->expiredCount++] = i;
+            grid->column[i] = -1;
+        } else if (y[i] + size > bandTop) {
+            int c = columnOf(x[i]);
+            grid->column[i] = c;
+            counts[c]++;
+        } else {
+            grid->column[i] = -1;
+        }
+    }
+
+    int start = 0;
+    for (int c = 0; c < GRID_COLUMNS; c++) {
+        grid->columnStart[c] = start;
+        start += counts[c];
+        counts[c] = grid->columnStart[c]; // reuse as the write cursor
+    }
+    grid->columnStart[GRID_COLUMNS] = start;
+    grid->itemCount = start;
+
+    for (int i = 0; i < count; i++) {
+        int c = grid->column[i];
+        if (c >= 0) {
+            grid->items[counts[c]++] = i;
+        }
+    }
+    return true;
+}
+
+// Columns that can hold an entity of this size overlapping [left, right)
+void broadphaseColumns(float left, float right, float size, int* first, int* last) {
+    *first = columnOf(left - size);
+    *last = columnOf(right);
+}
+
+void broadphaseFree(Broadphase* grid) {
+    TRACKED_FREE(grid->items);
+    TRACKED_FREE(grid->expired);
+    TRACKED_FREE(grid->column);
+    *grid = (Broadphase){0};
+}
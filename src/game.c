@@ -1,119 +1,113 @@
-#define _DEFAULT_SOURCE
 #include <stdio.h>
-#include <stdlib.h>
 #include "binary.h"
 #include "game.h"
-#include "draw.h"
-#include "input.h"
-#include <unistd.h>
 
-#define SCREEN_WIDTH 40
-#define SCREEN_HEIGHT 20
-
-static int bits[32];
-static int bitCount=0;
-static int collectedBits[32];
-static int collectedCount=0;
-static int playerpos;
-static int score;
-static int gameOver;
-static int dropIndex=0;
-static int dropPos=0;
-static int currentBitX;
+void gameInit(ConsoleGame* game, int number){
+    gameInitBoard(game, number, SCREEN_WIDTH, SCREEN_HEIGHT);
+}
 
-void gameInit(int number){
-    bitCount=binaryConvert(number,bits,32);
-    playerpos=SCREEN_WIDTH/2;
-    collectedCount=0;
-    score=0;
-    gameOver=0;
-    dropIndex=0;
-    dropPos=0;
-    currentBitX=SCREEN_WIDTH/2;
+void gameInitBoard(ConsoleGame* game, int number, int width, int height){
+    game->width = width < 4 ? 4 : width;
+    game->height = height < 2 ? 2 : height;
+    game->bitCount=binaryConvert(number,game->bits,GAME_MAX_BITS);
+    game->playerpos=game->width/2;
+    game->collectedCount=0;
+    game->score=0;
+    game->gameOver=0;
+    game->dropIndex=0;
+    game->dropPos=0;
+    game->currentBitX=game->width/2;
 }
 
-int gameIsOver(){
-    return gameOver;
+int gameIsOver(const ConsoleGame* game){
+    return game->gameOver;
 }
 
-int gameGetScore(){
-    return score;
+int gameGetScore(const ConsoleGame* game){
+    return game->score;
 }
 
-void gameUpdate(){
-    int input = inputGet();
-    if (input == -1){
-        //no key was pressed
-    }else if ((input == 'a' || input == 'A') && playerpos > 0){
-        playerpos--;
-    }else if ((input == 'd' || input == 'D') && playerpos < SCREEN_WIDTH-1){
-        playerpos++;
-    }else if (input == 'q' || input == 'Q'){
-        gameOver = 1;
-        return;
+void gameHandleKey(ConsoleGame* game, int key){
+    if ((key == 'a' || key == 'A') && game->playerpos > 0){
+        game->playerpos--;
+    }else if ((key == 'd' || key == 'D') && game->playerpos < game->width-1){
+        game->playerpos++;
+    }else if (key == 'q' || key == 'Q'){
+        game->gameOver = 1;
     }
+}
+
+void gameTick(ConsoleGame* game){
+    if (game->gameOver) return;
     
     // Simulate bits falling and collecting
-    if (dropIndex < bitCount){
-        dropPos++;
+    if (game->dropIndex < game->bitCount){
+        game->dropPos++;
         
-        if (dropPos >= SCREEN_HEIGHT-1){
+        if (game->dropPos >= game->height-1){
             // Bit reached bottom - check if player caught it
-            if (playerpos == currentBitX || playerpos+1 == currentBitX){
-                collectedBits[collectedCount++] = bits[dropIndex];
-                score += 10;
+            if (game->playerpos == game->currentBitX || game->playerpos+1 == game->currentBitX){
+                game->collectedBits[game->collectedCount++] = game->bits[game->dropIndex];
+                game->score += 10;
             }
             
             // Move to next bit
-            dropIndex++;
-            dropPos = 0;
-            if (dropIndex < bitCount) {
+            game->dropIndex++;
+            game->dropPos = 0;
+            if (game->dropIndex < game->bitCount) {
                 // Set position for next bit (spread them across screen)
-                currentBitX = (dropIndex * 7) % (SCREEN_WIDTH-2) + 1;
+                game->currentBitX = (game->dropIndex * 7) % (game->width-2) + 1;
             }
         }
     } else {
-        gameOver = 1;
+        game->gameOver = 1;
     }
-    
-    // Add small delay for smooth animation
-    usleep(150000); // 150ms delay
 }
 
-void gameDraw(){
-    system("clear");
+void gameUpdate(ConsoleGame* game, int input){
+    if (input != -1) gameHandleKey(game, input);
+    gameTick(game);
+}
+
+// Title, score line and a blank row above the board; border and collected
+// bits below it
+#define FRAME_TOP 4
+#define FRAME_MIN_WIDTH 80
+
+void gameFrameSize(const ConsoleGame* game, int* width, int* height){
+    *width = game->width + 2 > FRAME_MIN_WIDTH ? game->width + 2 : FRAME_MIN_WIDTH;
+    *height = FRAME_TOP + game->height + 2;
+}
+
+void gameRender(const ConsoleGame* game, TermRenderer* term){
+    char line[128];
+    termClear(term);
     
     // Draw game area
-    printf("\n=== BINARY QUEST ===\n");
-    printf("Score: %d | Bits Collected: %d/%d | Controls: A/D to move, Q to quit\n\n", score, collectedCount, bitCount);
+    termText(term, 0, 1, "=== BINARY QUEST ===");
+    snprintf(line, sizeof(line), "Score: %d | Bits Collected: %d/%d | Controls: A/D to move, Q to quit", game->score, game->collectedCount, game->bitCount);
+    termText(term, 0, 2, line);
     
     // Draw the falling bit and game area
-    for (int y = 0; y < SCREEN_HEIGHT; y++) {
-        printf("|");
-        for (int x = 0; x < SCREEN_WIDTH; x++) {
-            if (y == dropPos && x == currentBitX && dropIndex < bitCount) {
-                // Draw falling bit
-                printf("%d", bits[dropIndex]);
-            } else if (y == SCREEN_HEIGHT-1 && x == playerpos) {
-                // Draw player
-                printf("[");
-            } else if (y == SCREEN_HEIGHT-1 && x == playerpos+1) {
-                printf("]");
-            } else {
-                printf(" ");
-            }
-        }
-        printf("|\n");
+    for (int y = 0; y < game->height; y++) {
+        termPut(term, 0, FRAME_TOP + y, '|');
+        termPut(term, game->width + 1, FRAME_TOP + y, '|');
+    }
+    if (game->dropIndex < game->bitCount) {
+        termPut(term, 1 + game->currentBitX, FRAME_TOP + game->dropPos, (char)('0' + game->bits[game->dropIndex]));
+    }
+    termPut(term, 1 + game->playerpos, FRAME_TOP + game->height - 1, '[');
+    if (game->playerpos + 1 < game->width) {
+        termPut(term, 2 + game->playerpos, FRAME_TOP + game->height - 1, ']');
     }
     
     // Draw bottom border
-    for (int i = 0; i < SCREEN_WIDTH + 2; i++) printf("-");
-    printf("\n");
+    for (int i = 0; i < game->width + 2; i++) termPut(term, i, FRAME_TOP + game->height, '-');
     
     // Show collected bits
-    printf("Collected bits: ");
-    for (int i = 0; i < collectedCount; i++) {
-        printf("%d", collectedBits[i]);
+    int x = snprintf(line, sizeof(line), "Collected bits: ");
+    termText(term, 0, FRAME_TOP + game->height + 1, line);
+    for (int i = 0; i < game->collectedCount; i++) {
+        termPut(term, x + i, FRAME_TOP + game->height + 1, (char)('0' + game->collectedBits[i]));
     }
-    printf("\n");
 }
@@ -1,10 +1,40 @@
 #ifndef GAME_H
 #define GAME_H
 
-void gameInit(int number);
-void gameUpdate();
-int gameIsOver();
-void gameDraw();
-int gameGetScore();
+#include "term.h"
 
-#endif
\ No newline at end of file
+// Default board size; gameInitBoard takes any other
+#define SCREEN_WIDTH 40
+#define SCREEN_HEIGHT 20
+#define GAME_MAX_BITS 32
+#define GAME_STEP_MS 150 // default real-time pace of one tick in the console front end
+
+// One console game. All state lives here, so any number of games can be
+// stepped side by side; nothing here sleeps or does I/O, and the caller
+// decides how often to tick and when to draw.
+typedef struct {
+    int bits[GAME_MAX_BITS];
+    int bitCount;
+    int collectedBits[GAME_MAX_BITS];
+    int collectedCount;
+    int playerpos;
+    int score;
+    int gameOver;
+    int dropIndex;
+    int dropPos;
+    int currentBitX;
+    int width;  // board size in cells
+    int height;
+} ConsoleGame;
+
+void gameInit(ConsoleGame* game, int number);
+void gameInitBoard(ConsoleGame* game, int number, int width, int height);
+void gameHandleKey(ConsoleGame* game, int key); // move or quit, between ticks
+void gameTick(ConsoleGame* game);                 // one drop step
+void gameUpdate(ConsoleGame* game, int input);   // key (or -1 for none), then a tick
+int gameIsOver(const ConsoleGame* game);
+void gameFrameSize(const ConsoleGame* game, int* width, int* height);
+void gameRender(const ConsoleGame* game, TermRenderer* term);
+int gameGetScore(const ConsoleGame* game);
+
+#endif
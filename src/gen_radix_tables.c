@@ -0,0 +1,145 @@
+#include <stdio.h>
+#include <stdint.h>
+#include "binary.h"
+
+// Build-time generator for radix_tables.h (see the Makefile).
+// Digit decoding and everything level setup looks up at run time is
+// computed here once, so the game itself does no conversion arithmetic.
+
+#define LEVEL_TABLE_MAX 1000 // top of the stock difficulty ranges; larger numbers convert at run time
+#define OCTAL_LEVEL_MAX 777
+
+// Octal levels spell octal numbers with decimal digits; -1 if not valid octal
+static int octalSpellingValue(int spelled) {
+    int value = 0;
+    int shift = 0;
+    if (spelled == 0) {
+        return 0;
+    }
+    while (spelled > 0) {
+        int digit = spelled % 10;
+        if (digit >= 8) {
+            return -1;
+        }
+        value |= digit << shift;
+        shift += 3;
+        spelled /= 10;
+    }
+    return value;
+}
+
+static int bitLength(unsigned value) {
+    int length = 1;
+    while (value >> length) {
+        length++;
+    }
+    return length;
+}
+
+int main(void) {
+    printf("// Generated by gen_radix_tables.c - do not edit\n");
+    printf("#ifndef RADIX_TABLES_H\n#define RADIX_TABLES_H\n\n");
+    printf("#include <stdint.h>\n\n");
+    printf("#define RADIX_MIN 2\n#define RADIX_MAX 36\n");
+    printf("#define RADIX_INVALID_DIGIT 0xFF\n");
+    printf("#define LEVEL_TABLE_MAX %d\n\n", LEVEL_TABLE_MAX);
+
+    // Character -> digit value for every radix up to 36
+    printf("static const uint8_t RADIX_DIGIT_VALUE[256] = {");
+    for (int c = 0; c < 256; c++) {
+        int value = 0xFF;
+        if (c >= '0' && c <= '9') value = c - '0';
+        else if (c >= 'a' && c <= 'z') value = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'Z') value = c - 'A' + 10;
+        printf("%s0x%02X,", c % 16 ? " " : "\n    ", value);
+    }
+    printf("\n};\n\n");
+
+    // Bits per digit for power-of-two radices, 0 otherwise
+    printf("static const uint8_t RADIX_DIGIT_BITS[RADIX_MAX + 1] = {");
+    for (int radix = 0; radix <= 36; radix++) {
+        int bits = 0;
+        for (int b = 1; b <= 5; b++) {
+            if (radix == (1 << b)) bits = b;
+        }
+        printf("%s%d,", radix % 16 ? " " : "\n    ", bits);
+    }
+    printf("\n};\n\n");
+
+    // Digits per 64-bit chunk and radix^digits, for the chunked multiply-add
+    // parse of radices that are not powers of two
+    printf("static const uint8_t RADIX_CHUNK_DIGITS[RADIX_MAX + 1] = {");
+    for (int radix = 0; radix <= 36; radix++) {
+        int digits = 0;
+        if (radix >= 2) {
+            uint64_t base = 1;
+            while (base <= UINT64_MAX / (uint64_t)radix) {
+                base *= (uint64_t)radix;
+                digits++;
+            }
+        }
+        printf("%s%d,", radix % 16 ? " " : "\n    ", digits);
+    }
+    printf("\n};\n\n");
+
+    printf("static const uint64_t RADIX_CHUNK_BASE[RADIX_MAX + 1] = {");
+    for (int radix = 0; radix <= 36; radix++) {
+        uint64_t base = 1;
+        if (radix >= 2) {
+            while (base <= UINT64_MAX / (uint64_t)radix) {
+                base *= (uint64_t)radix;
+            }
+        }
+        printf("%s0x%016llXull,", radix % 4 ? " " : "\n    ", (unsigned long long)base);
+    }
+    printf("\n};\n\n");
+
+    // Precomputed conversions for every number a level can use, indexed by
+    // [ConversionType][number as the game stores it]
+    printf("static const uint16_t LEVEL_BITS_VALUE[3][LEVEL_TABLE_MAX + 1] = {\n");
+    for (int type = CONVERSION_DECIMAL; type <= CONVERSION_HEXADECIMAL; type++) {
+        printf("    {");
+        for (int n = 0; n <= LEVEL_TABLE_MAX; n++) {
+            int value = type == CONVERSION_OCTAL ? octalSpellingValue(n) : n;
+            printf("%s%d,", n % 16 ? " " : "\n        ", value < 0 ? 0 : value);
+        }
+        printf("\n    },\n");
+    }
+    printf("};\n\n");
+
+    printf("static const uint8_t LEVEL_BITS_LENGTH[3][LEVEL_TABLE_MAX + 1] = {\n");
+    for (int type = CONVERSION_DECIMAL; type <= CONVERSION_HEXADECIMAL; type++) {
+        printf("    {");
+        for (int n = 0; n <= LEVEL_TABLE_MAX; n++) {
+            int value = type == CONVERSION_OCTAL ? octalSpellingValue(n) : n;
+            printf("%s%d,", n % 16 ? " " : "\n        ", bitLength(value < 0 ? 0 : (unsigned)value));
+        }
+        printf("\n    },\n");
+    }
+    printf("};\n\n");
+
+    // Valid octal spellings in order, and how many are <= n, so an octal
+    // level number can be drawn uniformly without a rejection loop
+    int validCount = 0;
+    printf("static const uint16_t LEVEL_OCTAL_VALID[] = {");
+    for (int n = 0; n <= OCTAL_LEVEL_MAX; n++) {
+        if (octalSpellingValue(n) >= 0) {
+            printf("%s%d,", validCount % 16 ? " " : "\n    ", n);
+            validCount++;
+        }
+    }
+    printf("\n};\n\n");
+
+    printf("static const uint16_t LEVEL_OCTAL_RANK[LEVEL_TABLE_MAX + 1] = {");
+    int rank = 0;
+    for (int n = 0; n <= LEVEL_TABLE_MAX; n++) {
+        if (n <= OCTAL_LEVEL_MAX && octalSpellingValue(n) >= 0) {
+            rank++;
+        }
+        printf("%s%d,", n % 16 ? " " : "\n    ", rank);
+    }
+    printf("\n};\n\n");
+
+    printf("#endif\n");
+    return 0;
+}
@@ -1,21 +1,8 @@
 #include "gui_game.h"
-#include "binary.h"
+#include "trace.h"
 #include <stdio.h>
 #include <stdlib.h>
-#include <math.h>
-#include <time.h>
-
-// Color definitions
-const Color COLOR_WHITE = {255, 255, 255, 255};
-const Color COLOR_BLACK = {0, 0, 0, 255};
-const Color COLOR_RED = {255, 0, 0, 255};
-const Color COLOR_GREEN = {0, 255, 0, 255};
-const Color COLOR_BLUE = {0, 0, 255, 255};
-const Color COLOR_YELLOW = {255, 255, 0, 255};
-const Color COLOR_CYAN = {0, 255, 255, 255};
-const Color COLOR_MAGENTA = {255, 0, 255, 255};
-const Color COLOR_ORANGE = {255, 165, 0, 255};
-const Color COLOR_PURPLE = {128, 0, 128, 255};
+#include <string.h>
 
 bool initSDL(SDL_Window** window, SDL_Renderer** renderer) {
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) < 0) {
@@ -42,6 +29,9 @@ bool initSDL(SDL_Window** window, SDL_Renderer** renderer) {
         return false;
     }
 
+    // Overlays, particles and glyph edges all rely on their alpha
+    SDL_SetRenderDrawBlendMode(*renderer, SDL_BLENDMODE_BLEND);
+
     return true;
 }
 
@@ -52,496 +42,77 @@ void cleanupSDL(SDL_Window* window, SDL_Renderer* renderer) {
     SDL_Quit();
 }
 
-bool initGame(GameState* game, int number, ConversionType conversionType) {
-    srand(time(NULL));
-    
-    game->originalNumber = number;
-    game->conversionType = conversionType;
-    
-    // Clear bits array before conversion
-    for (int i = 0; i < MAX_BITS; i++) {
-        game->bits[i] = 0;
-    }
-    
-    game->bitCount = convertToBinary(number, game->bits, MAX_BITS, conversionType);
-    game->currentBitIndex = 0;
-    game->expectedBitIndex = 0;
-    game->score = 0;
-    game->level = 1;
-    game->collectedCount = 0;
-    game->gameOver = false;
-    game->paused = false;
-    game->gameSpeed = 1.0f;
-    game->nextBitTimer = 0;
-    game->powerUpSpawnTimer = 0;
-    game->showBinaryResult = false;
-    game->levelComplete = false;
-    game->wrongBitPenalty = 0;
-    game->continuousFallTimer = 0;
-    game->screenShakeTimer = 0;
-    game->screenShakeIntensity = 0.0f;
-    game->transitionTimer = 0;
-    game->isTransitioning = false;
-    game->nextLevelNumber = 0;
-    game->wrongBitCount = 0; // Initialize wrong bit counter
-    game->minNumber = 1;
-    game->maxNumber = 50; // Start with smaller numbers
-
-    // Initialize sound system
-    game->soundSystem = malloc(sizeof(SoundSystem));
-    if (game->soundSystem) {
-        soundInit(game->soundSystem);
-        // Try to load sound effects (optional - game works without them)
-        soundLoadEffects(game->soundSystem, "sounds");
-        soundLoadMusic(game->soundSystem, "sounds");
-        // Don't start music automatically - wait for user to start game
-    }
-
-    // Initialize player
-    game->player.x = GAME_AREA_X + GAME_AREA_WIDTH / 2 - PLAYER_WIDTH / 2;
-    game->player.width = PLAYER_WIDTH;
-    game->player.speed = 300.0f;
-    game->player.lives = 3;
-    game->player.hasSpeedBoost = false;
-    game->player.hasScoreMultiplier = false;
-    game->player.hasSlowTime = false;
-    // Initialize particles
-    game->particleCount = 0;
-    for (int i = 0; i < MAX_PARTICLES; i++) {
-        game->particles[i].life = 0.0f;
-    }
-
-    // Initialize falling bits
-    for (int i = 0; i < MAX_FALLING_BITS; i++) {
-        game->fallingBits[i].active = false;
-    }
-
-    // Initialize power-ups
-    for (int i = 0; i < 3; i++) {
-        game->powerUps[i].active = false;
-    }
-
-    return true;
-}
-
 void setRenderColor(SDL_Renderer* renderer, Color color) {
     SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
 }
 
-void spawnBit(GameState* game) {
-    // Spawn bits continuously, not just in order
-    for (int i = 0; i < MAX_FALLING_BITS; i++) {
-        if (!game->fallingBits[i].active) {
-            game->fallingBits[i].active = true;
-            game->fallingBits[i].x = GAME_AREA_X + rand() % (GAME_AREA_WIDTH - BIT_SIZE);
-            game->fallingBits[i].y = GAME_AREA_Y;
-            
-            // Spawn random bits from the binary representation
-            int randomBitIndex = rand() % game->bitCount;
-            game->fallingBits[i].value = game->bits[randomBitIndex];
-            game->fallingBits[i].speed = 80.0f + game->level * 15.0f;
-            
-            // Color based on bit value
-            if (game->fallingBits[i].value == 1) {
-                game->fallingBits[i].color = COLOR_GREEN;
-            } else {
-                game->fallingBits[i].color = COLOR_RED;
-            }
-            
+// Translate a key event into a simulation input; recorder may be NULL
+void handleInput(GameState* game, SDL_Event* event, Replay* recorder) {
+    if (event->type != SDL_KEYDOWN && event->type != SDL_KEYUP) return;
+    if (event->key.repeat) return; // held keys are already down
+
+    bool pressed = event->type == SDL_KEYDOWN;
+    SimInput input;
+    switch (event->key.keysym.sym) {
+        case SDLK_LEFT:
+        case SDLK_a:
+            input = pressed ? SIM_INPUT_LEFT_PRESS : SIM_INPUT_LEFT_RELEASE;
             break;
-        }
-    }
-}
-
-void spawnPowerUp(GameState* game) {
-    for (int i = 0; i < 3; i++) {
-        if (!game->powerUps[i].active) {
-            game->powerUps[i].active = true;
-            game->powerUps[i].x = GAME_AREA_X + rand() % (GAME_AREA_WIDTH - POWERUP_SIZE);
-            game->powerUps[i].y = GAME_AREA_Y;
-            game->powerUps[i].type = rand() % 3;
-            game->powerUps[i].speed = 80.0f;
-            game->powerUps[i].duration = 300; // 5 seconds at 60 FPS
+        case SDLK_RIGHT:
+        case SDLK_d:
+            input = pressed ? SIM_INPUT_RIGHT_PRESS : SIM_INPUT_RIGHT_RELEASE;
             break;
-        }
-    }
-}
-
-bool isCorrectBit(GameState* game, int bitValue) {
-    if (game->expectedBitIndex >= game->bitCount) {
-        return false; // All bits already collected
-    }
-    return game->bits[game->expectedBitIndex] == bitValue;
-}
-
-void generateNewLevel(GameState* game) {
-    game->level++;
-
-    // Increase difficulty by expanding number range (max 1000)
-    if (game->level <= 3) {
-        game->maxNumber = 100;
-    } else if (game->level <= 6) {
-        game->maxNumber = 250;
-    } else if (game->level <= 10) {
-        game->maxNumber = 500;
-    } else {
-        game->maxNumber = 1000; // Maximum limit as requested
-    }
-
-    // Generate random number for new level
-    int newNumber;
-    
-    if (game->conversionType == CONVERSION_OCTAL) {
-        // For octal, generate a valid octal number (no digits 8 or 9)
-        // Generate a decimal number first, then convert to octal representation
-        int maxOctal = game->maxNumber;
-        if (maxOctal > 777) maxOctal = 777; // Max valid octal in this range
-        
-        do {
-            newNumber = game->minNumber + rand() % (maxOctal - game->minNumber + 1);
-            // Check if all digits are valid octal (0-7)
-            int temp = newNumber;
-            bool validOctal = true;
-            while (temp > 0) {
-                if (temp % 10 >= 8) {
-                    validOctal = false;
-                    break;
-                }
-                temp /= 10;
-            }
-            if (validOctal || newNumber == 0) break;
-        } while (true);
-    } else {
-        newNumber = game->minNumber + rand() % (game->maxNumber - game->minNumber + 1);
-    }
-
-    // Reset level immediately instead of using transition
-    resetLevel(game, newNumber);
-}
-
-void resetLevel(GameState* game, int newNumber) {
-    game->originalNumber = newNumber;
-    
-    // Clear bits array before conversion to avoid old data
-    for (int i = 0; i < MAX_BITS; i++) {
-        game->bits[i] = 0;
-    }
-    
-    game->bitCount = convertToBinary(newNumber, game->bits, MAX_BITS, game->conversionType);
-    game->currentBitIndex = 0;
-    game->expectedBitIndex = 0;
-    game->collectedCount = 0;
-    game->levelComplete = false;
-    game->showBinaryResult = false;
-    game->continuousFallTimer = 0;
-    game->isTransitioning = false;
-    
-    // Clear collected bits array
-    for (int i = 0; i < MAX_BITS; i++) {
-        game->collectedBits[i] = 0;
-    }
-    
-    // Clear all falling bits
-    for (int i = 0; i < MAX_FALLING_BITS; i++) {
-        game->fallingBits[i].active = false;
-    }
-    
-    // Increase game speed slightly
-    game->gameSpeed = 1.0f + (game->level - 1) * 0.1f;
-}
-
-void checkCollisions(GameState* game) {
-    float playerLeft = game->player.x;
-    float playerRight = game->player.x + game->player.width;
-    float playerTop = GAME_AREA_Y + GAME_AREA_HEIGHT - PLAYER_HEIGHT;
-    float playerBottom = GAME_AREA_Y + GAME_AREA_HEIGHT;
-
-    // Check bit collisions
-    for (int i = 0; i < MAX_FALLING_BITS; i++) {
-        if (game->fallingBits[i].active) {
-            float bitLeft = game->fallingBits[i].x;
-            float bitRight = game->fallingBits[i].x + BIT_SIZE;
-            float bitTop = game->fallingBits[i].y;
-            float bitBottom = game->fallingBits[i].y + BIT_SIZE;
-
-            // Check collision with player
-            if (bitRight > playerLeft && bitLeft < playerRight &&
-                bitBottom > playerTop && bitTop < playerBottom) {
-                
-                // Check if this is the correct bit in sequence
-                if (isCorrectBit(game, game->fallingBits[i].value)) {
-                    // Correct bit collected
-                    game->collectedBits[game->collectedCount++] = game->fallingBits[i].value;
-                    game->expectedBitIndex++;
-                    
-                    int points = 10;
-                    if (game->player.hasScoreMultiplier) points *= 2;
-                    game->score += points;
-                    
-                    // Spawn particles for correct bit collection
-                    spawnParticles(game, game->fallingBits[i].x + BIT_SIZE/2,
-                                 game->fallingBits[i].y + BIT_SIZE/2,
-                                 PARTICLE_BIT_COLLECT, 8);
-                    
-                    // Play sound effect
-                    if (game->soundSystem) {
-                        soundPlayEffect(game->soundSystem, SOUND_BIT_COLLECT);
-                        printf("🔊 Playing pop sound for bit collection!\n");
-                    }
-                    
-                    // Check if level is complete
-                    if (game->expectedBitIndex >= game->bitCount) {
-                        game->levelComplete = true;
-                        game->score += 50 * game->level; // Bonus for completing level
-                        spawnParticles(game, game->fallingBits[i].x + BIT_SIZE/2,
-                                     game->fallingBits[i].y + BIT_SIZE/2,
-                                     PARTICLE_LEVEL_COMPLETE, 15);
-                        
-                        // Play level complete sound
-                        if (game->soundSystem) {
-                            soundPlayEffect(game->soundSystem, SOUND_LEVEL_COMPLETE);
-                        }
-                    }
-                } else {
-                    // Wrong bit collected - penalty
-                    game->wrongBitCount++;
-                    game->wrongBitPenalty = 60; // Show penalty indicator for 1 second
-                    
-                    // Trigger screen shake for wrong bit
-                    triggerScreenShake(game, 5.0f);
-                    
-                    // Spawn particles for wrong bit
-                    spawnParticles(game, game->fallingBits[i].x + BIT_SIZE/2,
-                                 game->fallingBits[i].y + BIT_SIZE/2,
-                                 PARTICLE_WRONG_BIT, 12);
-                    
-                    // Play wrong bit sound
-                    if (game->soundSystem) {
-                        soundPlayEffect(game->soundSystem, SOUND_WRONG_BIT);
-                    }
-                    
-                    // End game after 3 wrong bits
-                    if (game->wrongBitCount >= 3) {
-                        game->gameOver = true;
-                        // Stop screen shake immediately when game ends
-                        game->screenShakeTimer = 0;
-                        game->screenShakeIntensity = 0.0f;
-                        // Play game over sound and music (once, not looping)
-                        if (game->soundSystem) {
-                            soundPlayEffect(game->soundSystem, SOUND_GAME_OVER);
-                            soundPlayMusicOnce(game->soundSystem, MUSIC_GAME_OVER);
-                        }
-                    }
-                }
-                game->fallingBits[i].active = false;
-            }
-            // Check if bit reached bottom - just remove it, no penalty
-            else if (game->fallingBits[i].y > GAME_AREA_Y + GAME_AREA_HEIGHT) {
-                game->fallingBits[i].active = false;
-                // No penalty for missed bits - only wrong bit collection matters
-            }
-        }
-    }
-
-    // Check power-up collisions
-    for (int i = 0; i < 3; i++) {
-        if (game->powerUps[i].active) {
-            float powerUpLeft = game->powerUps[i].x;
-            float powerUpRight = game->powerUps[i].x + POWERUP_SIZE;
-            float powerUpTop = game->powerUps[i].y;
-            float powerUpBottom = game->powerUps[i].y + POWERUP_SIZE;
-
-            if (powerUpRight > playerLeft && powerUpLeft < playerRight &&
-                powerUpBottom > playerTop && powerUpTop < playerBottom) {
-                
-                // Activate power-up
-                switch (game->powerUps[i].type) {
-                    case 0: // Speed boost
-                        game->player.hasSpeedBoost = true;
-                        game->player.powerUpTimer[0] = game->powerUps[i].duration;
-                        spawnParticles(game, game->powerUps[i].x + POWERUP_SIZE/2,
-                                     game->powerUps[i].y + POWERUP_SIZE/2,
-                                     PARTICLE_POWERUP, 10);
-                        break;
-                    case 1: // Score multiplier
-                        game->player.hasScoreMultiplier = true;
-                        game->player.powerUpTimer[1] = game->powerUps[i].duration;
-                        spawnParticles(game, game->powerUps[i].x + POWERUP_SIZE/2,
-                                     game->powerUps[i].y + POWERUP_SIZE/2,
-                                     PARTICLE_POWERUP, 10);
-                        break;
-                    case 2: // Slow time
-                        game->player.hasSlowTime = true;
-                        game->player.powerUpTimer[2] = game->powerUps[i].duration;
-                        game->gameSpeed = 0.5f;
-                        spawnParticles(game, game->powerUps[i].x + POWERUP_SIZE/2,
-                                     game->powerUps[i].y + POWERUP_SIZE/2,
-                                     PARTICLE_POWERUP, 10);
-                        break;
-                }
-                // Play power-up sound
-                if (game->soundSystem) {
-                    soundPlayEffect(game->soundSystem, SOUND_POWERUP);
-                }
-                game->powerUps[i].active = false;
-                game->score += 5;
-            }
-            // Remove if reached bottom
-            else if (game->powerUps[i].y > GAME_AREA_Y + GAME_AREA_HEIGHT) {
-                game->powerUps[i].active = false;
-            }
-        }
-    }
-}
-
-void updatePowerUps(GameState* game, float deltaTime) {
-    for (int i = 0; i < 3; i++) {
-        if (game->player.powerUpTimer[i] > 0) {
-            game->player.powerUpTimer[i]--;
-            if (game->player.powerUpTimer[i] <= 0) {
-                switch (i) {
-                    case 0:
-                        game->player.hasSpeedBoost = false;
-                        break;
-                    case 1:
-                        game->player.hasScoreMultiplier = false;
-                        break;
-                    case 2:
-                        game->player.hasSlowTime = false;
-                        game->gameSpeed = 1.0f;
-                        break;
-                }
-            }
-        }
-    }
-}
-
-void updateGame(GameState* game, float deltaTime) {
-    if (game->gameOver || game->paused) return;
-
-    deltaTime *= game->gameSpeed;
-
-    // Update power-ups
-    updatePowerUps(game, deltaTime);
-    
-    // Update penalty indicator
-    if (game->wrongBitPenalty > 0) {
-        game->wrongBitPenalty--;
-    }
-
-    // Update particles
-    updateParticles(game, deltaTime);
-
-    // Update screen shake (but not when game is over)
-    if (game->screenShakeTimer > 0 && !game->gameOver) {
-        game->screenShakeTimer--;
-        if (game->screenShakeTimer <= 0) {
-            game->screenShakeIntensity = 0.0f;
-        }
-    } else if (game->gameOver) {
-        // Stop screen shake immediately when game ends
-        game->screenShakeTimer = 0;
-        game->screenShakeIntensity = 0.0f;
-    }
-
-    // Update level transition
-    updateTransition(game, deltaTime);
-
-    // Handle level completion
-    if (game->levelComplete && !game->isTransitioning) {
-        game->continuousFallTimer += deltaTime * 60;
-        if (game->continuousFallTimer >= 120) { // Wait 2 seconds before next level
-            generateNewLevel(game);
-        }
-        return; // Don't spawn new bits during level transition
-    }
-
-    // Spawn new bits continuously (faster spawning)
-    game->nextBitTimer += deltaTime * 60;
-    int spawnRate = 30 - (game->level * 2); // Faster spawning at higher levels
-    if (spawnRate < 10) spawnRate = 10; // Minimum spawn rate
-    
-    if (game->nextBitTimer >= spawnRate) {
-        spawnBit(game);
-        game->nextBitTimer = 0;
-    }
-
-    // Spawn power-ups occasionally
-    game->powerUpSpawnTimer += deltaTime * 60;
-    if (game->powerUpSpawnTimer >= 300) { // Every 5 seconds
-        if (rand() % 3 == 0) { // 33% chance
-            spawnPowerUp(game);
-        }
-        game->powerUpSpawnTimer = 0;
-    }
-
-    // Update falling bits
-    for (int i = 0; i < MAX_FALLING_BITS; i++) {
-        if (game->fallingBits[i].active) {
-            game->fallingBits[i].y += game->fallingBits[i].speed * deltaTime;
-        }
+        case SDLK_SPACE:
+            if (!pressed) return;
+            input = SIM_INPUT_PAUSE;
+            break;
+        case SDLK_q:
+            if (!pressed) return;
+            input = SIM_INPUT_QUIT;
+            break;
+        default:
+            return;
     }
 
-    // Update power-ups
-    for (int i = 0; i < 3; i++) {
-        if (game->powerUps[i].active) {
-            game->powerUps[i].y += game->powerUps[i].speed * deltaTime;
-        }
+    simApplyInput(game, input);
+    if (recorder) {
+        replayRecord(recorder, game, input);
     }
-
-    // Check collisions
-    checkCollisions(game);
-
-    // Level completion is now handled in collision detection
 }
 
-void handleInput(GameState* game, SDL_Event* event) {
-    if (event->type == SDL_KEYDOWN) {
-        switch (event->key.keysym.sym) {
-            case SDLK_LEFT:
-            case SDLK_a:
-                if (game->player.x > GAME_AREA_X) {
-                    float speed = game->player.speed;
-                    if (game->player.hasSpeedBoost) speed *= 1.5f;
-                    game->player.x -= speed * 0.016f; // Assume 60 FPS
-                }
+// Play the sounds for everything the simulation reported since the last call
+void playGameEvents(GameState* game, SoundSystem* sound) {
+    for (int i = 0; i < game->eventCount; i++) {
+        switch (game->events[i]) {
+            case SIM_EVENT_BIT_COLLECT:
+                soundPlayEffect(sound, SOUND_BIT_COLLECT);
                 break;
-            case SDLK_RIGHT:
-            case SDLK_d:
-                if (game->player.x < GAME_AREA_X + GAME_AREA_WIDTH - game->player.width) {
-                    float speed = game->player.speed;
-                    if (game->player.hasSpeedBoost) speed *= 1.5f;
-                    game->player.x += speed * 0.016f;
-                }
+            case SIM_EVENT_WRONG_BIT:
+                soundPlayEffect(sound, SOUND_WRONG_BIT);
                 break;
-            case SDLK_SPACE:
-                game->paused = !game->paused;
+            case SIM_EVENT_LEVEL_COMPLETE:
+                soundPlayEffect(sound, SOUND_LEVEL_COMPLETE);
                 break;
-            case SDLK_q:
-                game->gameOver = true;
+            case SIM_EVENT_POWERUP:
+                soundPlayEffect(sound, SOUND_POWERUP);
+                break;
+            case SIM_EVENT_GAME_OVER:
+                // Game over sound and music (once, not looping)
+                soundPlayEffect(sound, SOUND_GAME_OVER);
+                soundPlayMusicOnce(sound, MUSIC_GAME_OVER);
                 break;
         }
     }
+    simClearEvents(game);
 }
 
-void renderText(SDL_Renderer* renderer, TTF_Font* font, const char* text, 
+void renderText(SDL_Renderer* renderer, TextAtlas* atlas, const char* text, 
                 int x, int y, Color color) {
-    if (!font) return;
-    
-    SDL_Color sdlColor = {color.r, color.g, color.b, color.a};
-    SDL_Surface* textSurface = TTF_RenderText_Solid(font, text, sdlColor);
-    if (textSurface) {
-        SDL_Texture* textTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
-        if (textTexture) {
-            SDL_Rect destRect = {x, y, textSurface->w, textSurface->h};
-            SDL_RenderCopy(renderer, textTexture, NULL, &destRect);
-            SDL_DestroyTexture(textTexture);
-        }
-        SDL_FreeSurface(textSurface);
-    }
+    TRACE_FUNCTION();
+    textAtlasDraw(atlas, renderer, text, x, y, color);
 }
 
-void renderButton(SDL_Renderer* renderer, TTF_Font* font, const char* text,
+void renderButton(SDL_Renderer* renderer, TextAtlas* atlas, const char* text,
                   int x, int y, int width, int height, Color bgColor, Color textColor) {
     // Draw button background
     setRenderColor(renderer, bgColor);
@@ -553,16 +124,23 @@ void renderButton(SDL_Renderer* renderer, TTF_Font* font, const char* text,
     SDL_RenderDrawRect(renderer, &buttonRect);
     
     // Draw button text (centered)
-    if (font) {
+    if (atlas->texture) {
         int textW, textH;
-        TTF_SizeText(font, text, &textW, &textH);
+        textAtlasMeasure(atlas, text, &textW, &textH);
         int textX = x + (width - textW) / 2;
         int textY = y + (height - textH) / 2;
-        renderText(renderer, font, text, textX, textY, textColor);
+        renderText(renderer, atlas, text, textX, textY, textColor);
     }
 }
 
-void renderGame(SDL_Renderer* renderer, TTF_Font* font, GameState* game) {
+// Position between the last two simulation ticks
+static float lerp(float from, float to, float alpha) {
+    return from + (to - from) * alpha;
+}
+
+// alpha is how far real time has run past the last tick, in ticks (0-1)
+void renderGame(SDL_Renderer* renderer, TextAtlas* atlas, QuadBatch* batch, GameState* game, float alpha) {
+    TRACE_FUNCTION();
     // Clear screen with dark blue background
     setRenderColor(renderer, (Color){20, 20, 40, 255});
     SDL_RenderClear(renderer);
@@ -570,8 +148,14 @@ void renderGame(SDL_Renderer* renderer, TTF_Font* font, GameState* game) {
     // Apply screen shake (but not when game is over)
     int shakeX = 0, shakeY = 0;
     if (game->screenShakeTimer > 0 && !game->gameOver) {
-        shakeX = (rand() % (int)(game->screenShakeIntensity * 2)) - game->screenShakeIntensity;
-        shakeY = (rand() % (int)(game->screenShakeIntensity * 2)) - game->screenShakeIntensity;
+        // Hashed from the tick rather than drawn from a stream, so rendering
+        // never changes what the simulation does next
+        int range = (int)(game->screenShakeIntensity * 2);
+        uint64_t noise = rngHash64(game->seed ^ ((uint64_t)game->tick << 32));
+        if (range > 0) {
+            shakeX = (int)((uint32_t)noise % range) - (int)game->screenShakeIntensity;
+            shakeY = (int)((uint32_t)(noise >> 32) % range) - (int)game->screenShakeIntensity;
+        }
     }
 
     // Draw game area border
@@ -584,61 +168,56 @@ void renderGame(SDL_Renderer* renderer, TTF_Font* font, GameState* game) {
     SDL_Rect gameAreaBg = {GAME_AREA_X + shakeX, GAME_AREA_Y + shakeY, GAME_AREA_WIDTH, GAME_AREA_HEIGHT};
     SDL_RenderFillRect(renderer, &gameAreaBg);
 
-    // Draw title
+    // HUD text: title, score line, number and status messages
+    profileBegin(PROFILE_HUD_TEXT);
     char title[100];
     sprintf(title, "BINARY QUEST - Enhanced Edition");
-    renderText(renderer, font, title, 200, 20, COLOR_CYAN);
+    renderText(renderer, atlas, title, 200, 20, COLOR_CYAN);
 
     // Draw score and info
     char scoreText[200];
     sprintf(scoreText, "Score: %d | Level: %d | Wrong Bits: %d/3 | Range: %d-%d", 
             game->score, game->level, game->wrongBitCount, game->minNumber, game->maxNumber);
-    renderText(renderer, font, scoreText, 50 + shakeX, 50 + shakeY, COLOR_WHITE);
+    renderText(renderer, atlas, scoreText, 50 + shakeX, 50 + shakeY, COLOR_WHITE);
 
     // Draw original number with conversion type
-    char numberText[150];
+    char numberText[MAX_NUMBER_DIGITS + MAX_BITS + 64];
     const char* conversionName = "";
     switch (game->conversionType) {
         case CONVERSION_DECIMAL: conversionName = "Decimal"; break;
         case CONVERSION_OCTAL: conversionName = "Octal"; break;
         case CONVERSION_HEXADECIMAL: conversionName = "Hexadecimal"; break;
     }
-    sprintf(numberText, "%s: %d -> Binary: ", conversionName, game->originalNumber);
-    for (int i = 0; i < game->bitCount; i++) {
-        char bit[2];
-        sprintf(bit, "%d", game->bits[i]);
-        strcat(numberText, bit);
-    }
-    renderText(renderer, font, numberText, 50 + shakeX, WINDOW_HEIGHT - 110 + shakeY, COLOR_CYAN);
+    char bitsText[MAX_BITS + 1];
+    bitvecFormat(&game->bits, bitsText, sizeof(bitsText));
+    sprintf(numberText, "%s: %s -> Binary: %s", conversionName, game->numberDigits, bitsText);
+    renderText(renderer, atlas, numberText, 50 + shakeX, WINDOW_HEIGHT - 110 + shakeY, COLOR_CYAN);
 
     // Draw collected bits
-    char collectedText[200] = "Collected: ";
-    for (int i = 0; i < game->collectedCount; i++) {
-        char bit[2];
-        sprintf(bit, "%d", game->collectedBits[i]);
-        strcat(collectedText, bit);
-    }
-    renderText(renderer, font, collectedText, 50 + shakeX, WINDOW_HEIGHT - 80 + shakeY, COLOR_GREEN);
+    char collectedText[MAX_BITS + 16];
+    bitvecFormat(&game->collectedBits, bitsText, sizeof(bitsText));
+    sprintf(collectedText, "Collected: %s", bitsText);
+    renderText(renderer, atlas, collectedText, 50 + shakeX, WINDOW_HEIGHT - 80 + shakeY, COLOR_GREEN);
     
     // Show next expected bit
-    if (game->expectedBitIndex < game->bitCount) {
+    if (game->expectedBitIndex < game->bits.length) {
         char expectedText[100];
-        sprintf(expectedText, "Next bit needed: %d", game->bits[game->expectedBitIndex]);
-        renderText(renderer, font, expectedText, 50 + shakeX, WINDOW_HEIGHT - 50 + shakeY, COLOR_ORANGE);
+        sprintf(expectedText, "Next bit needed: %d", bitvecGet(&game->bits, game->expectedBitIndex));
+        renderText(renderer, atlas, expectedText, 50 + shakeX, WINDOW_HEIGHT - 50 + shakeY, COLOR_ORANGE);
     }
 
     // Draw power-up status
     int powerUpY = 100;
     if (game->player.hasSpeedBoost) {
-        renderText(renderer, font, "SPEED BOOST!", WINDOW_WIDTH - 150, powerUpY, COLOR_YELLOW);
+        renderText(renderer, atlas, "SPEED BOOST!", WINDOW_WIDTH - 150, powerUpY, COLOR_YELLOW);
         powerUpY += 25;
     }
     if (game->player.hasScoreMultiplier) {
-        renderText(renderer, font, "2X SCORE!", WINDOW_WIDTH - 150, powerUpY, COLOR_MAGENTA);
+        renderText(renderer, atlas, "2X SCORE!", WINDOW_WIDTH - 150, powerUpY, COLOR_MAGENTA);
         powerUpY += 25;
     }
     if (game->player.hasSlowTime) {
-        renderText(renderer, font, "SLOW TIME!", WINDOW_WIDTH - 150, powerUpY, COLOR_PURPLE);
+        renderText(renderer, atlas, "SLOW TIME!", WINDOW_WIDTH - 150, powerUpY, COLOR_PURPLE);
         powerUpY += 25;
     }
     
@@ -647,90 +226,72 @@ void renderGame(SDL_Renderer* renderer, TTF_Font* font, GameState* game) {
         char penaltyText[150];
         sprintf(penaltyText, "WRONG BIT! (%d/3) - Expected: %d", 
                 game->wrongBitCount, 
-                game->expectedBitIndex < game->bitCount ? game->bits[game->expectedBitIndex] : -1);
-        renderText(renderer, font, penaltyText, WINDOW_WIDTH/2 - 120 + shakeX, 150 + shakeY, COLOR_RED);
+                game->expectedBitIndex < game->bits.length ? bitvecGet(&game->bits, game->expectedBitIndex) : -1);
+        renderText(renderer, atlas, penaltyText, WINDOW_WIDTH/2 - 120 + shakeX, 150 + shakeY, COLOR_RED);
     }
     
     // Show level completion
     if (game->levelComplete) {
-        renderText(renderer, font, "LEVEL COMPLETE!", WINDOW_WIDTH/2 - 80 + shakeX, 200 + shakeY, COLOR_GREEN);
+        renderText(renderer, atlas, "LEVEL COMPLETE!", WINDOW_WIDTH/2 - 80 + shakeX, 200 + shakeY, COLOR_GREEN);
         char bonusText[50];
         sprintf(bonusText, "Bonus: +%d points", 50 * game->level);
-        renderText(renderer, font, bonusText, WINDOW_WIDTH/2 - 80 + shakeX, 230 + shakeY, COLOR_CYAN);
+        renderText(renderer, atlas, bonusText, WINDOW_WIDTH/2 - 80 + shakeX, 230 + shakeY, COLOR_CYAN);
     }
+    profileEnd(PROFILE_HUD_TEXT);
 
     if (!game->gameOver) {
+        // Entities are queued into two batches, shapes and their labels, so
+        // the number of draw calls does not grow with the number of entities
+        QuadBatch* labels = &atlas->batch;
+
         // Draw falling bits
-        for (int i = 0; i < MAX_FALLING_BITS; i++) {
-            if (game->fallingBits[i].active) {
-                setRenderColor(renderer, game->fallingBits[i].color);
-                SDL_Rect bitRect = {
-                    (int)game->fallingBits[i].x + shakeX,
-                    (int)game->fallingBits[i].y + shakeY,
-                    BIT_SIZE,
-                    BIT_SIZE
-                };
-                SDL_RenderFillRect(renderer, &bitRect);
-                
-                // Draw bit value
-                char bitText[2];
-                sprintf(bitText, "%d", game->fallingBits[i].value);
-                renderText(renderer, font, bitText, 
-                          (int)game->fallingBits[i].x + 8 + shakeX, 
-                          (int)game->fallingBits[i].y + 5 + shakeY, 
-                          COLOR_WHITE);
-            }
+        const BitPool* bits = &game->fallingBits;
+        for (int i = 0; i < bits->count; i++) {
+            int bitX = (int)lerp(bits->prevX[i], bits->x[i], alpha) + shakeX;
+            int bitY = (int)lerp(bits->prevY[i], bits->y[i], alpha) + shakeY;
+            quadBatchAddRect(batch, bitX, bitY, BIT_SIZE, BIT_SIZE, bits->value[i] ? COLOR_GREEN : COLOR_RED);
+            textAtlasAppend(atlas, labels, bits->value[i] ? "1" : "0", bitX + 8, bitY + 5, COLOR_WHITE);
         }
 
         // Draw power-ups
-        for (int i = 0; i < 3; i++) {
-            if (game->powerUps[i].active) {
-                Color powerUpColor;
-                char powerUpSymbol[2];
-                switch (game->powerUps[i].type) {
-                    case 0: powerUpColor = COLOR_YELLOW; strcpy(powerUpSymbol, "S"); break;
-                    case 1: powerUpColor = COLOR_ORANGE; strcpy(powerUpSymbol, "M"); break;
-                    case 2: powerUpColor = COLOR_PURPLE; strcpy(powerUpSymbol, "T"); break;
-                }
-                
-                setRenderColor(renderer, powerUpColor);
-                SDL_Rect powerUpRect = {
-                    (int)game->powerUps[i].x + shakeX,
-                    (int)game->powerUps[i].y + shakeY,
-                    POWERUP_SIZE,
-                    POWERUP_SIZE
-                };
-                SDL_RenderFillRect(renderer, &powerUpRect);
-                
-                renderText(renderer, font, powerUpSymbol, 
-                          (int)game->powerUps[i].x + 8 + shakeX, 
-                          (int)game->powerUps[i].y + 5 + shakeY, 
-                          COLOR_BLACK);
+        const PowerUpPool* powerUps = &game->powerUps;
+        for (int i = 0; i < powerUps->count; i++) {
+            Color powerUpColor;
+            const char* powerUpSymbol;
+            switch (powerUps->type[i]) {
+                case 0: powerUpColor = COLOR_YELLOW; powerUpSymbol = "S"; break;
+                case 1: powerUpColor = COLOR_ORANGE; powerUpSymbol = "M"; break;
+                default: powerUpColor = COLOR_PURPLE; powerUpSymbol = "T"; break;
             }
+
+            int drawX = (int)lerp(powerUps->prevX[i], powerUps->x[i], alpha) + shakeX;
+            int drawY = (int)lerp(powerUps->prevY[i], powerUps->y[i], alpha) + shakeY;
+            quadBatchAddRect(batch, drawX, drawY, POWERUP_SIZE, POWERUP_SIZE, powerUpColor);
+            textAtlasAppend(atlas, labels, powerUpSymbol, drawX + 8, drawY + 5, COLOR_BLACK);
         }
 
         // Draw player
-        setRenderColor(renderer, COLOR_CYAN);
-        SDL_Rect playerRect = {
-            (int)game->player.x + shakeX,
-            GAME_AREA_Y + GAME_AREA_HEIGHT - PLAYER_HEIGHT + shakeY,
-            game->player.width,
-            PLAYER_HEIGHT
-        };
-        SDL_RenderFillRect(renderer, &playerRect);
-
-        // Render particles
-        renderParticles(renderer, game);
+        quadBatchAddRect(batch,
+                         (int)lerp(game->player.prevX, game->player.x, alpha) + shakeX,
+                         GAME_AREA_Y + GAME_AREA_HEIGHT - PLAYER_HEIGHT + shakeY,
+                         game->player.width, PLAYER_HEIGHT, COLOR_CYAN);
+
+        quadBatchFlush(batch, renderer, NULL);
+        quadBatchFlush(labels, renderer, atlas->texture);
+
+        // Render particles on top
+        renderParticles(renderer, batch, game);
     }
 
-    // Draw pause screen
+    // Pause and game over screens and the controls line are text on a shade
+    profileBegin(PROFILE_HUD_TEXT);
     if (game->paused) {
         setRenderColor(renderer, (Color){0, 0, 0, 128});
         SDL_Rect pauseOverlay = {0, 0, WINDOW_WIDTH, WINDOW_HEIGHT};
         SDL_RenderFillRect(renderer, &pauseOverlay);
         
-        renderText(renderer, font, "PAUSED", WINDOW_WIDTH/2 - 50 + shakeX, WINDOW_HEIGHT/2 - 20 + shakeY, COLOR_WHITE);
-        renderText(renderer, font, "Press SPACE to continue", WINDOW_WIDTH/2 - 120 + shakeX, WINDOW_HEIGHT/2 + 20 + shakeY, COLOR_WHITE);
+        renderText(renderer, atlas, "PAUSED", WINDOW_WIDTH/2 - 50 + shakeX, WINDOW_HEIGHT/2 - 20 + shakeY, COLOR_WHITE);
+        renderText(renderer, atlas, "Press SPACE to continue", WINDOW_WIDTH/2 - 120 + shakeX, WINDOW_HEIGHT/2 + 20 + shakeY, COLOR_WHITE);
     }
 
     // Draw game over screen
@@ -739,126 +300,89 @@ void renderGame(SDL_Renderer* renderer, TTF_Font* font, GameState* game) {
         SDL_Rect gameOverOverlay = {0, 0, WINDOW_WIDTH, WINDOW_HEIGHT};
         SDL_RenderFillRect(renderer, &gameOverOverlay);
         
-        renderText(renderer, font, "GAME OVER", WINDOW_WIDTH/2 - 80 + shakeX, WINDOW_HEIGHT/2 - 80 + shakeY, COLOR_RED);
+        renderText(renderer, atlas, "GAME OVER", WINDOW_WIDTH/2 - 80 + shakeX, WINDOW_HEIGHT/2 - 80 + shakeY, COLOR_RED);
         
         char finalScore[100];
         sprintf(finalScore, "Final Score: %d", game->score);
-        renderText(renderer, font, finalScore, WINDOW_WIDTH/2 - 80 + shakeX, WINDOW_HEIGHT/2 - 40 + shakeY, COLOR_WHITE);
+        renderText(renderer, atlas, finalScore, WINDOW_WIDTH/2 - 80 + shakeX, WINDOW_HEIGHT/2 - 40 + shakeY, COLOR_WHITE);
         
         char wrongBitsText[100];
         sprintf(wrongBitsText, "Wrong bits collected: %d/3", game->wrongBitCount);
-        renderText(renderer, font, wrongBitsText, WINDOW_WIDTH/2 - 100 + shakeX, WINDOW_HEIGHT/2 - 10 + shakeY, COLOR_RED);
+        renderText(renderer, atlas, wrongBitsText, WINDOW_WIDTH/2 - 100 + shakeX, WINDOW_HEIGHT/2 - 10 + shakeY, COLOR_RED);
         
         char levelText[100];
         sprintf(levelText, "Levels completed: %d", game->level - 1);
-        renderText(renderer, font, levelText, WINDOW_WIDTH/2 - 80 + shakeX, WINDOW_HEIGHT/2 + 20 + shakeY, COLOR_CYAN);
+        renderText(renderer, atlas, levelText, WINDOW_WIDTH/2 - 80 + shakeX, WINDOW_HEIGHT/2 + 20 + shakeY, COLOR_CYAN);
         
-        renderText(renderer, font, "Press Q to quit", WINDOW_WIDTH/2 - 80 + shakeX, WINDOW_HEIGHT/2 + 50 + shakeY, COLOR_WHITE);
+        renderText(renderer, atlas, "Press Q to quit", WINDOW_WIDTH/2 - 80 + shakeX, WINDOW_HEIGHT/2 + 50 + shakeY, COLOR_WHITE);
     }
 
     // Draw controls
-    renderText(renderer, font, "Controls: A/D or Arrow Keys to move, SPACE to pause, Q to quit", 
+    renderText(renderer, atlas, "Controls: A/D or Arrow Keys to move, SPACE to pause, Q to quit", 
                50 + shakeX, WINDOW_HEIGHT - 20 + shakeY, COLOR_WHITE);
-
-    SDL_RenderPresent(renderer);
-}
-
-void spawnParticles(GameState* game, float x, float y, ParticleType type, int count) {
-    for (int i = 0; i < count && game->particleCount < MAX_PARTICLES; i++) {
-        Particle* p = &game->particles[game->particleCount++];
-        p->x = x;
-        p->y = y;
-        p->life = 1.0f;
-        p->size = 2.0f + rand() % 4;
-
-        // Set particle properties based on type
-        switch (type) {
-            case PARTICLE_BIT_COLLECT:
-                p->color = (Color){0, 255, 100, 255}; // Green
-                p->vx = (rand() % 200 - 100) * 0.1f;
-                p->vy = (rand() % 100 - 150) * 0.1f;
-                break;
-            case PARTICLE_WRONG_BIT:
-                p->color = (Color){255, 50, 50, 255}; // Red
-                p->vx = (rand() % 300 - 150) * 0.1f;
-                p->vy = (rand() % 200 - 250) * 0.1f;
-                p->size *= 1.5f; // Larger particles for wrong bits
-                break;
-            case PARTICLE_LEVEL_COMPLETE:
-                p->color = (Color){255, 215, 0, 255}; // Gold
-                p->vx = (rand() % 400 - 200) * 0.1f;
-                p->vy = (rand() % 300 - 400) * 0.1f;
-                p->size *= 2.0f; // Larger particles for level complete
-                break;
-            case PARTICLE_POWERUP:
-                p->color = (Color){255, 255, 0, 255}; // Yellow
-                p->vx = (rand() % 150 - 75) * 0.1f;
-                p->vy = (rand() % 150 - 200) * 0.1f;
-                break;
-        }
-    }
-}
-
-void updateParticles(GameState* game, float deltaTime) {
-    for (int i = game->particleCount - 1; i >= 0; i--) {
-        Particle* p = &game->particles[i];
-
-        // Update position
-        p->x += p->vx;
-        p->y += p->vy;
-
-        // Update life
-        p->life -= deltaTime * 2.0f; // 0.5 second lifetime
-
-        // Apply gravity
-        p->vy += 50.0f * deltaTime;
-
-        // Remove dead particles
-        if (p->life <= 0.0f) {
-            // Move last particle to current position
-            *p = game->particles[--game->particleCount];
-        }
-    }
-}
-
-void triggerScreenShake(GameState* game, float intensity) {
-    game->screenShakeTimer = SCREEN_SHAKE_DURATION;
-    game->screenShakeIntensity = intensity;
-}
-
-void startLevelTransition(GameState* game, int nextNumber) {
-    game->isTransitioning = true;
-    game->transitionTimer = TRANSITION_DURATION;
-    game->nextLevelNumber = nextNumber;
+    profileEnd(PROFILE_HUD_TEXT);
 }
 
-void updateTransition(GameState* game, float deltaTime) {
-    if (game->isTransitioning) {
-        game->transitionTimer--;
-        if (game->transitionTimer <= 0) {
-            game->isTransitioning = false;
-            resetLevel(game, game->nextLevelNumber);
-        }
+void renderParticles(SDL_Renderer* renderer, QuadBatch* batch, GameState* game) {
+    const ParticlePool* particles = &game->particles;
+    for (int i = 0; i < particles->count; i++) {
+        // Fade out with remaining life
+        Color color = particles->color[i];
+        color.a = (Uint8)(particles->life[i] * 255);
+        float size = particles->size[i];
+        quadBatchAddRect(batch, particles->x[i] - size/2, particles->y[i] - size/2, size, size, color);
     }
+    quadBatchFlush(batch, renderer, NULL);
 }
 
-void renderParticles(SDL_Renderer* renderer, GameState* game) {
-    for (int i = 0; i < game->particleCount; i++) {
-        Particle* p = &game->particles[i];
-        if (p->life > 0.0f) {
-            // Set particle color with alpha based on life
-            Color color = p->color;
-            color.a = (Uint8)(p->life * 255);
-            setRenderColor(renderer, color);
-            
-            // Draw particle as a small rectangle
-            SDL_Rect particleRect = {
-                (int)(p->x - p->size/2),
-                (int)(p->y - p->size/2),
-                (int)p->size,
-                (int)p->size
-            };
-            SDL_RenderFillRect(renderer, &particleRect);
-        }
-    }
+#define OVERLAY_WIDTH 300
+#define OVERLAY_GRAPH_HEIGHT 80
+#define OVERLAY_MS_PER_GRAPH 33.4f // graph top: two 60 Hz frames
+#define OVERLAY_BAR_WIDTH 2
+
+// Frame-time graph (newest on the right) and percentile table. The summary
+// is passed in so the caller decides how often to re-sort the history.
+void renderProfiler(SDL_Renderer* renderer, TextAtlas* atlas, QuadBatch* batch,
+                    const Profiler* profiler, const ProfileSummary* summary) {
+    int x = WINDOW_WIDTH - OVERLAY_WIDTH - 10;
+    int y = 10;
+    int lines = PROFILE_PHASE_COUNT + 3;
+    int height = OVERLAY_GRAPH_HEIGHT + 10 + lines * atlas->lineHeight + 10;
+    quadBatchAddRect(batch, x - 5, y - 5, OVERLAY_WIDTH + 10, height, (Color){0, 0, 0, 180});
+
+    // One bar per frame, green within a 60 Hz budget, yellow within two
+    float scale = OVERLAY_GRAPH_HEIGHT / OVERLAY_MS_PER_GRAPH;
+    int graphBottom = y + OVERLAY_GRAPH_HEIGHT;
+    int bars = OVERLAY_WIDTH / OVERLAY_BAR_WIDTH;
+    for (int age = 0; age < bars; age++) {
+        const ProfileFrame* frame = profilerFrame(profiler, age);
+        if (!frame) break;
+        float ms = frame->total / 1e6f;
+        float barHeight = ms * scale;
+        if (barHeight > OVERLAY_GRAPH_HEIGHT) barHeight = OVERLAY_GRAPH_HEIGHT;
+        Color color = ms <= 16.7f ? COLOR_GREEN : ms <= 33.4f ? COLOR_YELLOW : COLOR_RED;
+        quadBatchAddRect(batch, x + OVERLAY_WIDTH - (age + 1) * OVERLAY_BAR_WIDTH,
+                         graphBottom - barHeight, OVERLAY_BAR_WIDTH, barHeight, color);
+    }
+    quadBatchAddRect(batch, x, graphBottom - 16.7f * scale, OVERLAY_WIDTH, 1, COLOR_WHITE);
+    quadBatchFlush(batch, renderer, NULL);
+
+    char line[96];
+    int textY = graphBottom + 10;
+    snprintf(line, sizeof(line), "ms over %d frames   p50    p95    p99", summary->frames);
+    renderText(renderer, atlas, line, x, textY, COLOR_CYAN);
+    textY += atlas->lineHeight;
+    snprintf(line, sizeof(line), "frame         %6.2f %6.2f %6.2f",
+             summary->frame.p50, summary->frame.p95, summary->frame.p99);
+    renderText(renderer, atlas, line, x, textY, COLOR_WHITE);
+    for (int p = 0; p < PROFILE_PHASE_COUNT; p++) {
+        textY += atlas->lineHeight;
+        snprintf(line, sizeof(line), "%-12s %6.2f %6.2f %6.2f", profilePhaseName(p),
+                 summary->phase[p].p50, summary->phase[p].p95, summary->phase[p].p99);
+        renderText(renderer, atlas, line, x, textY, COLOR_WHITE);
+    }
+    textY += atlas->lineHeight;
+    snprintf(line, sizeof(line), "allocations %llu in %d frames",
+             (unsigned long long)summary->allocations, summary->allocatingFrames);
+    renderText(renderer, atlas, line, x, textY, summary->allocations > 0 ? COLOR_RED : COLOR_GREEN);
 }
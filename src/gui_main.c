@@ -4,27 +4,11 @@
 #include <time.h>
 #include <string.h>
 #include "gui_game.h"
+#include "bignum.h"
 #include "sound.h"
-
-// Helper function to parse hexadecimal string to integer
-int parseHexString(const char* hexStr) {
-    int result = 0;
-    int len = strlen(hexStr);
-    
-    for (int i = 0; i < len; i++) {
-        result *= 16;
-        char c = hexStr[i];
-        if (c >= '0' && c <= '9') {
-            result += c - '0';
-        } else if (c >= 'A' && c <= 'F') {
-            result += c - 'A' + 10;
-        } else if (c >= 'a' && c <= 'f') {
-            result += c - 'a' + 10;
-        }
-    }
-    
-    return result;
-}
+#include "snapshot.h"
+#include "trace.h"
+#include "alloc.h"
 
 // Menu states
 typedef enum {
@@ -37,60 +21,56 @@ typedef enum {
 
 typedef struct {
     MenuState currentMenu;
-    int inputNumber;
-    char inputBuffer[20];
+    char inputBuffer[MAX_NUMBER_DIGITS + 1];
     int inputLength;
     bool numberEntered;
+    bool inputTooLarge;
     ConversionType conversionType;
 } MenuSystem;
 
-void renderMainMenu(SDL_Renderer* renderer, TTF_Font* font, MenuSystem* menu) {
+void renderMainMenu(SDL_Renderer* renderer, TextAtlas* atlas, MenuSystem* menu) {
     // Clear screen with gradient background
     setRenderColor(renderer, (Color){10, 10, 30, 255});
     SDL_RenderClear(renderer);
 
     // Draw title with glow effect
-    renderText(renderer, font, "BINARY QUEST", WINDOW_WIDTH/2 - 120, 100, COLOR_CYAN);
-    renderText(renderer, font, "Enhanced Edition", WINDOW_WIDTH/2 - 100, 140, COLOR_YELLOW);
+    renderText(renderer, atlas, "BINARY QUEST", WINDOW_WIDTH/2 - 120, 100, COLOR_CYAN);
+    renderText(renderer, atlas, "Enhanced Edition", WINDOW_WIDTH/2 - 100, 140, COLOR_YELLOW);
 
     // Draw subtitle
-    renderText(renderer, font, "Catch the falling binary bits!", WINDOW_WIDTH/2 - 150, 200, COLOR_WHITE);
+    renderText(renderer, atlas, "Catch the falling binary bits!", WINDOW_WIDTH/2 - 150, 200, COLOR_WHITE);
 
     // Draw menu options
-    renderButton(renderer, font, "Start New Game", WINDOW_WIDTH/2 - 100, 280, 200, 50, COLOR_BLUE, COLOR_WHITE);
-    renderButton(renderer, font, "Instructions", WINDOW_WIDTH/2 - 100, 350, 200, 50, COLOR_GREEN, COLOR_WHITE);
-    renderButton(renderer, font, "Quit", WINDOW_WIDTH/2 - 100, 420, 200, 50, COLOR_RED, COLOR_WHITE);
+    renderButton(renderer, atlas, "Start New Game", WINDOW_WIDTH/2 - 100, 280, 200, 50, COLOR_BLUE, COLOR_WHITE);
+    renderButton(renderer, atlas, "Instructions", WINDOW_WIDTH/2 - 100, 350, 200, 50, COLOR_GREEN, COLOR_WHITE);
+    renderButton(renderer, atlas, "Quit", WINDOW_WIDTH/2 - 100, 420, 200, 50, COLOR_RED, COLOR_WHITE);
 
     // Draw version info
-    renderText(renderer, font, "v2.0 - SDL2 Enhanced", 10, WINDOW_HEIGHT - 30, (Color){128, 128, 128, 255});
-    
-    SDL_RenderPresent(renderer);
+    renderText(renderer, atlas, "v2.0 - SDL2 Enhanced", 10, WINDOW_HEIGHT - 30, (Color){128, 128, 128, 255});
 }
 
-void renderConversionSelectMenu(SDL_Renderer* renderer, TTF_Font* font, MenuSystem* menu) {
+void renderConversionSelectMenu(SDL_Renderer* renderer, TextAtlas* atlas, MenuSystem* menu) {
     // Clear screen with gradient background
     setRenderColor(renderer, (Color){10, 10, 30, 255});
     SDL_RenderClear(renderer);
 
     // Draw title
-    renderText(renderer, font, "SELECT CONVERSION TYPE", WINDOW_WIDTH/2 - 150, 100, COLOR_CYAN);
-    renderText(renderer, font, "Choose what to convert to Binary", WINDOW_WIDTH/2 - 150, 140, COLOR_WHITE);
+    renderText(renderer, atlas, "SELECT CONVERSION TYPE", WINDOW_WIDTH/2 - 150, 100, COLOR_CYAN);
+    renderText(renderer, atlas, "Choose what to convert to Binary", WINDOW_WIDTH/2 - 150, 140, COLOR_WHITE);
 
     // Draw conversion type options
-    renderButton(renderer, font, "Decimal to Binary", WINDOW_WIDTH/2 - 120, 200, 240, 50, COLOR_GREEN, COLOR_WHITE);
-    renderButton(renderer, font, "Octal to Binary", WINDOW_WIDTH/2 - 120, 270, 240, 50, COLOR_BLUE, COLOR_WHITE);
-    renderButton(renderer, font, "Hexadecimal to Binary", WINDOW_WIDTH/2 - 120, 340, 240, 50, COLOR_PURPLE, COLOR_WHITE);
+    renderButton(renderer, atlas, "Decimal to Binary", WINDOW_WIDTH/2 - 120, 200, 240, 50, COLOR_GREEN, COLOR_WHITE);
+    renderButton(renderer, atlas, "Octal to Binary", WINDOW_WIDTH/2 - 120, 270, 240, 50, COLOR_BLUE, COLOR_WHITE);
+    renderButton(renderer, atlas, "Hexadecimal to Binary", WINDOW_WIDTH/2 - 120, 340, 240, 50, COLOR_PURPLE, COLOR_WHITE);
     
     // Draw back button
-    renderButton(renderer, font, "Back to Menu", WINDOW_WIDTH/2 - 100, 430, 200, 40, COLOR_RED, COLOR_WHITE);
+    renderButton(renderer, atlas, "Back to Menu", WINDOW_WIDTH/2 - 100, 430, 200, 40, COLOR_RED, COLOR_WHITE);
 
     // Draw instructions
-    renderText(renderer, font, "Click a button or press 1/2/3", WINDOW_WIDTH/2 - 140, 500, COLOR_YELLOW);
-    
-    SDL_RenderPresent(renderer);
+    renderText(renderer, atlas, "Click a button or press 1/2/3", WINDOW_WIDTH/2 - 140, 500, COLOR_YELLOW);
 }
 
-void renderInputMenu(SDL_Renderer* renderer, TTF_Font* font, MenuSystem* menu) {
+void renderInputMenu(SDL_Renderer* renderer, TextAtlas* atlas, MenuSystem* menu) {
     setRenderColor(renderer, (Color){10, 10, 30, 255});
     SDL_RenderClear(renderer);
 
@@ -112,9 +92,9 @@ void renderInputMenu(SDL_Renderer* renderer, TTF_Font* font, MenuSystem* menu) {
             break;
     }
     
-    renderText(renderer, font, conversionName, WINDOW_WIDTH/2 - 120, 150, COLOR_CYAN);
-    renderText(renderer, font, "Enter a Number", WINDOW_WIDTH/2 - 100, 200, COLOR_YELLOW);
-    renderText(renderer, font, inputHint, WINDOW_WIDTH/2 - 200, 240, COLOR_WHITE);
+    renderText(renderer, atlas, conversionName, WINDOW_WIDTH/2 - 120, 150, COLOR_CYAN);
+    renderText(renderer, atlas, "Enter a Number", WINDOW_WIDTH/2 - 100, 200, COLOR_YELLOW);
+    renderText(renderer, atlas, inputHint, WINDOW_WIDTH/2 - 200, 240, COLOR_WHITE);
 
     // Draw input box
     SDL_Rect inputBox = {WINDOW_WIDTH/2 - 100, 300, 200, 40};
@@ -126,7 +106,7 @@ void renderInputMenu(SDL_Renderer* renderer, TTF_Font* font, MenuSystem* menu) {
 
     // Draw input text
     if (menu->inputLength > 0) {
-        renderText(renderer, font, menu->inputBuffer, WINDOW_WIDTH/2 - 90, 310, COLOR_WHITE);
+        renderText(renderer, atlas, menu->inputBuffer, WINDOW_WIDTH/2 - 90, 310, COLOR_WHITE);
     }
 
     // Draw cursor
@@ -136,36 +116,39 @@ void renderInputMenu(SDL_Renderer* renderer, TTF_Font* font, MenuSystem* menu) {
         SDL_RenderDrawLine(renderer, cursorX, 310, cursorX, 330);
     }
 
-    renderText(renderer, font, "Press ENTER to start game", WINDOW_WIDTH/2 - 130, 380, COLOR_GREEN);
-    renderText(renderer, font, "Press ESC to go back", WINDOW_WIDTH/2 - 110, 410, COLOR_YELLOW);
+    if (menu->inputTooLarge) {
+        char tooLargeText[64];
+        sprintf(tooLargeText, "Number too large (max %d bits)", MAX_BITS);
+        renderText(renderer, atlas, tooLargeText, WINDOW_WIDTH/2 - 140, 350, COLOR_RED);
+    }
 
-    SDL_RenderPresent(renderer);
+    renderText(renderer, atlas, "Press ENTER to start game", WINDOW_WIDTH/2 - 130, 380, COLOR_GREEN);
+    renderText(renderer, atlas, "Press ESC to go back", WINDOW_WIDTH/2 - 110, 410, COLOR_YELLOW);
 }
 
-void renderInstructions(SDL_Renderer* renderer, TTF_Font* font) {
+void renderInstructions(SDL_Renderer* renderer, TextAtlas* atlas) {
     setRenderColor(renderer, (Color){10, 10, 30, 255});
     SDL_RenderClear(renderer);
 
-    renderText(renderer, font, "HOW TO PLAY", WINDOW_WIDTH/2 - 80, 50, COLOR_CYAN);
+    renderText(renderer, atlas, "HOW TO PLAY", WINDOW_WIDTH/2 - 80, 50, COLOR_CYAN);
 
     int y = 120;
-    renderText(renderer, font, "• Enter a number to convert to binary", 100, y, COLOR_WHITE); y += 30;
-    renderText(renderer, font, "• Use A/D or Arrow Keys to move your collector", 100, y, COLOR_WHITE); y += 30;
-    renderText(renderer, font, "• Catch falling bits (1s and 0s) to score points", 100, y, COLOR_WHITE); y += 30;
-    renderText(renderer, font, "• Green bits (1) and Red bits (0)", 100, y, COLOR_WHITE); y += 30;
-    renderText(renderer, font, "• Collect power-ups for special abilities:", 100, y, COLOR_WHITE); y += 40;
+    renderText(renderer, atlas, "• Enter a number to convert to binary", 100, y, COLOR_WHITE); y += 30;
+    renderText(renderer, atlas, "• Use A/D or Arrow Keys to move your collector", 100, y, COLOR_WHITE); y += 30;
+    renderText(renderer, atlas, "• Catch falling bits (1s and 0s) to score points", 100, y, COLOR_WHITE); y += 30;
+    renderText(renderer, atlas, "• Green bits (1) and Red bits (0)", 100, y, COLOR_WHITE); y += 30;
+    renderText(renderer, atlas, "• Collect power-ups for special abilities:", 100, y, COLOR_WHITE); y += 40;
     
-    renderText(renderer, font, "  S - Speed Boost (Yellow)", 120, y, COLOR_YELLOW); y += 25;
-    renderText(renderer, font, "  M - Score Multiplier (Orange)", 120, y, COLOR_ORANGE); y += 25;
-    renderText(renderer, font, "  T - Slow Time (Purple)", 120, y, COLOR_PURPLE); y += 40;
+    renderText(renderer, atlas, "  S - Speed Boost (Yellow)", 120, y, COLOR_YELLOW); y += 25;
+    renderText(renderer, atlas, "  M - Score Multiplier (Orange)", 120, y, COLOR_ORANGE); y += 25;
+    renderText(renderer, atlas, "  T - Slow Time (Purple)", 120, y, COLOR_PURPLE); y += 40;
     
-    renderText(renderer, font, "• Don't let bits reach the bottom!", 100, y, COLOR_RED); y += 30;
-    renderText(renderer, font, "• You have 3 lives", 100, y, COLOR_WHITE); y += 30;
-    renderText(renderer, font, "• Press SPACE to pause, Q to quit", 100, y, COLOR_WHITE);
-
-    renderText(renderer, font, "Press any key to return to menu", WINDOW_WIDTH/2 - 150, WINDOW_HEIGHT - 50, COLOR_GREEN);
+    renderText(renderer, atlas, "• Don't let bits reach the bottom!", 100, y, COLOR_RED); y += 30;
+    renderText(renderer, atlas, "• You have 3 lives", 100, y, COLOR_WHITE); y += 30;
+    renderText(renderer, atlas, "• Press SPACE to pause, Q to quit", 100, y, COLOR_WHITE); y += 30;
+    renderText(renderer, atlas, "• Hold R to rewind, F5/F9 to quick save/load, F3 for timings", 100, y, COLOR_WHITE);
 
-    SDL_RenderPresent(renderer);
+    renderText(renderer, atlas, "Press any key to return to menu", WINDOW_WIDTH/2 - 150, WINDOW_HEIGHT - 50, COLOR_GREEN);
 }
 
 bool handleMenuInput(MenuSystem* menu, SDL_Event* event) {
@@ -177,18 +160,22 @@ bool handleMenuInput(MenuSystem* menu, SDL_Event* event) {
         if (event->type == SDL_KEYDOWN) {
             if (event->key.keysym.sym == SDLK_ESCAPE) {
                 menu->currentMenu = MENU_MAIN;
+                menu->inputTooLarge = false;
                 menu->inputLength = 0;
                 menu->inputBuffer[0] = '\0';
             } else if (event->key.keysym.sym == SDLK_RETURN && menu->inputLength > 0) {
-                // Parse input based on conversion type
-                if (menu->conversionType == CONVERSION_HEXADECIMAL) {
-                    menu->inputNumber = parseHexString(menu->inputBuffer);
+                // Parse input based on conversion type; values of any width
+                // up to MAX_BITS are accepted
+                BitVector value;
+                if (convertDigitsToBinary(menu->inputBuffer, menu->conversionType, &value)) {
+                    menu->inputTooLarge = false;
+                    menu->numberEntered = true;
+                    menu->currentMenu = MENU_GAME;
                 } else {
-                    menu->inputNumber = atoi(menu->inputBuffer);
+                    menu->inputTooLarge = true;
                 }
-                menu->numberEntered = true;
-                menu->currentMenu = MENU_GAME;
             } else if (event->key.keysym.sym == SDLK_BACKSPACE && menu->inputLength > 0) {
+                menu->inputTooLarge = false;
                 menu->inputLength--;
                 menu->inputBuffer[menu->inputLength] = '\0';
             }
@@ -216,7 +203,7 @@ bool handleMenuInput(MenuSystem* menu, SDL_Event* event) {
                 }
             }
             
-            if (validChar && menu->inputLength < 18) {
+            if (validChar && menu->inputLength < MAX_NUMBER_DIGITS) {
                 menu->inputBuffer[menu->inputLength] = c;
                 menu->inputLength++;
                 menu->inputBuffer[menu->inputLength] = '\0';
@@ -298,14 +285,105 @@ bool handleMenuInput(MenuSystem* menu, SDL_Event* event) {
     return true;
 }
 
+// Close out the recording of the current game and write it to disk
+static void saveRecording(Replay* recorder, GameState* game, const char* path) {
+    if (!recorder->recording) return;
+    replayFinish(recorder, game);
+    if (replaySave(recorder, path)) {
+        printf("Recorded %d inputs over %u ticks to %s\n", recorder->count, (unsigned)recorder->endTick, path);
+    } else {
+        printf("Could not write replay: %s\n", path);
+    }
+}
+
+#define REWIND_SECONDS 10
+#define QUICKSAVE_PATH "quicksave.bqs"
+#define PROFILE_FRAMES 600        // ten seconds at 60 Hz
+#define PROFILE_SUMMARY_FRAMES 30 // frames between overlay percentile updates
+
 int main(int argc, char* argv[]) {
     SDL_Window* window = NULL;
     SDL_Renderer* renderer = NULL;
     TTF_Font* font = NULL;
+    static TextAtlas textAtlas;
+    TextAtlas* atlas = &textAtlas;
+    QuadBatch batch;
+
+    // --seed N replays the same falling bits, power-ups and levels every game;
+    // --record FILE logs the first game's inputs (as the headless build does)
+    // and --replay FILE plays one back;
+    // --profile FILE writes the frame-phase history out as CSV on exit and
+    // --trace FILE the zone timeline as Chrome trace JSON (make TRACE=1);
+    // --counters prints hardware counter totals per phase on exit
+    bool fixedSeed = false;
+    uint64_t seed = 0;
+    const char* recordPath = NULL;
+    const char* replayPath = NULL;
+    const char* profilePath = NULL;
+    const char* tracePath = NULL;
+    bool countPerf = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], NULL, 10);
+            fixedSeed = true;
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+            profilePath = argv[++i];
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else if (strcmp(argv[i], "--counters") == 0) {
+            countPerf = true;
+        }
+    }
+
+    static Replay recorder;
+    bool recordStarted = false;
+    static Replay playback;
+    bool playingBack = false;
+
+    // Snapshot of every tick for rewinding; the recording (if any) ends
+    // when the player rewinds or loads, since the inputs no longer line up
+    static SnapshotRing rewindRing;
+    if (!snapshotRingInit(&rewindRing, REWIND_SECONDS * SIM_TICK_RATE)) {
+        printf("Could not allocate the rewind buffer\n");
+        return 1;
+    }
+    // Phase times of the last PROFILE_FRAMES frames; F3 shows them
+    static Profiler profiler;
+    if (!profilerInit(&profiler, PROFILE_FRAMES)) {
+        printf("Could not allocate the profiler\n");
+        return 1;
+    }
+    profilerInstall(&profiler);
+    static PerfCounters counters;
+    if (countPerf) {
+        if (perfOpen(&counters)) {
+            profilerAttachCounters(&profiler, &counters);
+        } else {
+            printf("Hardware counters unavailable (needs Linux perf events; see perf_event_paranoid)\n");
+            countPerf = false;
+        }
+    }
+    ProfileSummary profileSummary = {0};
+    bool showProfiler = false;
+    if (replayPath) {
+        if (!replayLoad(&playback, replayPath)) {
+            printf("Could not read replay: %s\n", replayPath);
+            return 1;
+        }
+    }
     
     if (!initSDL(&window, &renderer)) {
         return 1;
     }
+    // PRESENTVSYNC is only a request; software renderers and drivers with
+    // vsync forced off ignore it, and then the loop has to pace itself
+    SDL_RendererInfo rendererInfo;
+    bool vsync = SDL_GetRendererInfo(renderer, &rendererInfo) == 0 &&
+                 (rendererInfo.flags & SDL_RENDERER_PRESENTVSYNC);
 
     // Try to load a font (system font or fallback)
     // Try Windows fonts first
@@ -333,10 +411,19 @@ int main(int argc, char* argv[]) {
         // Continue without font - text won't render but game will still work
     }
 
-    // Initialize menu sound system (but don't start music yet)
-    SoundSystem menuSound = {0};
-    soundInit(&menuSound);
-    soundLoadMusic(&menuSound, "sounds");
+    // Rasterize the font once; all text is drawn from the atlas after this
+    textAtlasCreate(atlas, renderer, font);
+    if (font) {
+        TTF_CloseFont(font);
+    }
+    quadBatchInit(&batch);
+
+    // Initialize the sound system once for menus and games (but don't start music yet)
+    SoundSystem sound = {0};
+    soundInit(&sound);
+    // Try to load sound effects (optional - game works without them)
+    soundLoadEffects(&sound, "sounds");
+    soundLoadMusic(&sound, "sounds");
     // Music will start when user clicks "Start New Game"
 
     MenuSystem menu = {0};
@@ -349,17 +436,63 @@ int main(int argc, char* argv[]) {
     GameState game = {0};
     bool quit = false;
     bool showInstructions = false;
-    Uint32 lastTime = SDL_GetTicks();
+    // Fixed-timestep loop: real time accumulates and the simulation
+    // consumes it in SIM_TICK_SECONDS steps, whatever the refresh rate
+    Uint64 counterFrequency = SDL_GetPerformanceFrequency();
+    Uint64 lastCounter = SDL_GetPerformanceCounter();
+    float accumulator = 0.0f;
+
+    if (replayPath) {
+        if (!replayStart(&playback, &game)) {
+            printf("Replay has an invalid number: %s\n", playback.digits);
+            return 1;
+        }
+        printf("Replaying %s (seed %llu)\n", replayPath, (unsigned long long)game.seed);
+        snapshotRingPush(&rewindRing, &game);
+        menu.currentMenu = MENU_GAME;
+        playingBack = true;
+        soundPlayMusicOnce(&sound, MUSIC_MENU);
+    }
 
     while (!quit) {
-        Uint32 currentTime = SDL_GetTicks();
-        float deltaTime = (currentTime - lastTime) / 1000.0f;
-        lastTime = currentTime;
+        TRACE_ZONE("frame");
+        profileFrameBegin();
+        Uint64 currentCounter = SDL_GetPerformanceCounter();
+        float frameTime = (float)(currentCounter - lastCounter) / (float)counterFrequency;
+        lastCounter = currentCounter;
+        if (frameTime > 0.25f) {
+            frameTime = 0.25f; // Don't try to catch up after a long stall
+        }
 
+        profileBegin(PROFILE_EVENTS);
         SDL_Event event;
         while (SDL_PollEvent(&event)) {
+            if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F3 && !event.key.repeat) {
+                showProfiler = !showProfiler;
+                profilerSummarize(&profiler, &profileSummary);
+                continue;
+            }
+            if (menu.currentMenu == MENU_GAME && !playingBack && event.type == SDL_KEYDOWN) {
+                if (event.key.keysym.sym == SDLK_F5) {
+                    if (snapshotSave(&game, QUICKSAVE_PATH)) {
+                        printf("Saved game to %s\n", QUICKSAVE_PATH);
+                    }
+                } else if (event.key.keysym.sym == SDLK_F9) {
+                    if (recordPath) {
+                        saveRecording(&recorder, &game, recordPath);
+                    }
+                    if (snapshotLoad(&game, QUICKSAVE_PATH)) {
+                        snapshotRingClear(&rewindRing);
+                        snapshotRingPush(&rewindRing, &game);
+                        printf("Loaded game from %s\n", QUICKSAVE_PATH);
+                    }
+                }
+            }
             if (menu.currentMenu == MENU_GAME && !game.gameOver) {
-                handleInput(&game, &event);
+                // Keyboard input is ignored while a replay drives the game
+                if (!playingBack) {
+                    handleInput(&game, &event, recordPath ? &recorder : NULL);
+                }
                 if (event.type == SDL_QUIT) {
                     quit = true;
                 }
@@ -390,59 +523,157 @@ int main(int argc, char* argv[]) {
             }
         }
 
+        profileEnd(PROFILE_EVENTS);
+
         // Initialize game when number is entered
+        profileBegin(PROFILE_UPDATE);
         if (menu.numberEntered) {
-            initGame(&game, menu.inputNumber, menu.conversionType);
-            // Play gamestart.mp3 once when user clicks "Start New Game"
-            if (game.soundSystem) {
-                soundPlayMusicOnce(game.soundSystem, MUSIC_MENU); // This plays gamestart.mp3 once
+            simSetSeed(&game, fixedSeed ? seed : simClockSeed());
+            initGameFromDigits(&game, menu.inputBuffer, menu.conversionType);
+            printf("Game seed: %llu (run with --seed to replay)\n", (unsigned long long)game.seed);
+            // Only the first game is recorded, so FILE is never overwritten
+            if (recordPath && !recordStarted) {
+                replayBegin(&recorder, &game, SIM_TICK_SECONDS);
+                recordStarted = true;
             }
+            snapshotRingClear(&rewindRing);
+            snapshotRingPush(&rewindRing, &game);
+            accumulator = 0.0f;
+            // Play gamestart.mp3 once when user clicks "Start New Game"
+            soundPlayMusicOnce(&sound, MUSIC_MENU);
             menu.numberEntered = false;
         }
 
         // Update game
+        float alpha = 0.0f;
         if (menu.currentMenu == MENU_GAME) {
-            updateGame(&game, deltaTime);
+            accumulator += frameTime;
+            bool rewinding = !playingBack && SDL_GetKeyboardState(NULL)[SDL_SCANCODE_R];
+            if (rewinding && recordPath) {
+                saveRecording(&recorder, &game, recordPath);
+            }
+            while (accumulator >= SIM_TICK_SECONDS) {
+                if (rewinding) {
+                    // Step back one tick per tick of real time
+                    snapshotRingRewind(&rewindRing, &game, 1);
+                    accumulator -= SIM_TICK_SECONDS;
+                    continue;
+                }
+                if (playingBack) {
+                    if (replayDone(&playback, &game)) break;
+                    replayApply(&playback, &game);
+                }
+                uint32_t tickBefore = game.tick;
+                updateGame(&game, SIM_TICK_SECONDS);
+                if (game.tick != tickBefore) {
+                    snapshotRingPush(&rewindRing, &game);
+                }
+                accumulator -= SIM_TICK_SECONDS;
+            }
+            if (playingBack && replayDone(&playback, &game)) {
+                accumulator = 0.0f;
+            }
+            alpha = accumulator / SIM_TICK_SECONDS;
+            playGameEvents(&game, &sound);
             
             // Check if gamestart music finished, then start background music
-            if (game.soundSystem && !soundIsMusicPlaying(game.soundSystem) && !game.gameOver) {
-                soundPlayMusic(game.soundSystem, MUSIC_BACKGROUND);
+            if (!soundIsMusicPlaying(&sound) && !game.gameOver) {
+                soundPlayMusic(&sound, MUSIC_BACKGROUND);
             }
             
             // Return to menu when game is over and Q is pressed
             if (game.gameOver) {
+                if (recordPath) {
+                    saveRecording(&recorder, &game, recordPath);
+                }
                 SDL_PumpEvents();
                 const Uint8* keystate = SDL_GetKeyboardState(NULL);
                 if (keystate[SDL_SCANCODE_Q]) {
                     menu.currentMenu = MENU_MAIN;
                     menu.inputLength = 0;
                     menu.inputBuffer[0] = '\0';
+                    playingBack = false;
                 }
             }
         }
+        profileEnd(PROFILE_UPDATE);
+
+        // Render; menus are all text, the game charges its HUD text itself
+        if (menu.currentMenu == MENU_GAME && !showInstructions) {
+            profileBegin(PROFILE_ENTITIES);
+            renderGame(renderer, atlas, &batch, &game, alpha);
+            profileEnd(PROFILE_ENTITIES);
+        } else {
+            profileBegin(PROFILE_HUD_TEXT);
+            if (showInstructions) {
+                renderInstructions(renderer, atlas);
+            } else if (menu.currentMenu == MENU_MAIN) {
+                renderMainMenu(renderer, atlas, &menu);
+            } else if (menu.currentMenu == MENU_CONVERSION_SELECT) {
+                renderConversionSelectMenu(renderer, atlas, &menu);
+            } else if (menu.currentMenu == MENU_INPUT) {
+                renderInputMenu(renderer, atlas, &menu);
+            }
+            profileEnd(PROFILE_HUD_TEXT);
+        }
 
-        // Render
-        if (showInstructions) {
-            renderInstructions(renderer, font);
-        } else if (menu.currentMenu == MENU_MAIN) {
-            renderMainMenu(renderer, font, &menu);
-        } else if (menu.currentMenu == MENU_CONVERSION_SELECT) {
-            renderConversionSelectMenu(renderer, font, &menu);
-        } else if (menu.currentMenu == MENU_INPUT) {
-            renderInputMenu(renderer, font, &menu);
-        } else if (menu.currentMenu == MENU_GAME) {
-            renderGame(renderer, font, &game);
+        // The overlay itself is left out of every phase
+        if (showProfiler) {
+            if (profiler.frameIndex % PROFILE_SUMMARY_FRAMES == 0) {
+                profilerSummarize(&profiler, &profileSummary);
+            }
+            renderProfiler(renderer, atlas, &batch, &profiler, &profileSummary);
         }
 
-        SDL_Delay(16); // Cap at ~60 FPS
+        // With vsync on, present also waits for the display
+        profileBegin(PROFILE_PRESENT);
+        SDL_RenderPresent(renderer);
+        profileEnd(PROFILE_PRESENT);
+
+        if (vsync) {
+            SDL_Delay(1); // Vsync paces frames; just yield the CPU
+        } else {
+            // Sleep out the rest of one tick's frame budget
+            float spent = (float)(SDL_GetPerformanceCounter() - currentCounter) / (float)counterFrequency;
+            if (spent < SIM_TICK_SECONDS) {
+                SDL_Delay((Uint32)((SIM_TICK_SECONDS - spent) * 1000.0f));
+            }
+        }
+        profileFrameEnd();
     }
 
-    if (font) {
-        TTF_CloseFont(font);
+    if (profilePath) {
+        if (profilerWriteCsv(&profiler, profilePath)) {
+            printf("Wrote %d profiled frames to %s\n", profiler.count, profilePath);
+            allocReport(stdout);
+        } else {
+            printf("Could not write profile: %s\n", profilePath);
+        }
+    }
+    if (countPerf) {
+        profilerPrintCounters(&profiler, stdout);
+        perfClose(&counters);
+    }
+    profilerFree(&profiler);
+    if (tracePath && traceWrite(tracePath)) {
+        printf("Wrote trace to %s\n", tracePath);
     }
+    traceFree();
+
+    // A game still in progress at exit is saved up to its last tick
+    if (recordPath) {
+        saveRecording(&recorder, &game, recordPath);
+    }
+    replayFree(&recorder);
+    replayFree(&playback);
+    snapshotRingFree(&rewindRing);
+
+    textAtlasDestroy(atlas);
+    quadBatchFree(&batch);
+    simFree(&game);
     
-    // Cleanup menu sound system
-    soundCleanup(&menuSound);
+    // Cleanup sound system
+    soundCleanup(&sound);
     
     cleanupSDL(window, renderer);
     
@@ -0,0 +1,371 @@
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sim.h"
+#include "replay.h"
+#include "snapshot.h"
+#include "bot.h"
+#include "profiler.h"
+#include "trace.h"
+#include "alloc.h"
+#include "bignum.h"
+
+// Headless runner: advances the simulation core with no SDL, display or
+// audio device. The player sweeps back and forth across the play field (or
+// is driven by the autoplay bot), or a recorded session is replayed as fast
+// as the CPU allows.
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void printUsage(const char* program) {
+    printf("Usage: %s [--number N] [--type dec|oct|hex] [--ticks N] [--dt SECONDS] [--storm BITS_PER_TICK] [--particles SCALE] [--seed N] [--record FILE]\n", program);
+    printf("       [--autoplay] [--rewind SLOTS] [--save-state FILE] [--load-state FILE] [--profile FILE] [--trace FILE] [--counters]\n");
+    printf("       [--check-alloc WARMUP_TICKS]\n");
+    printf("       %s --replay FILE [--repeat N]\n", program);
+    printf("       %s --check-bignum\n", program);
+}
+
+static void sendInput(GameState* game, Replay* recorder, SimInput input) {
+    simApplyInput(game, input);
+    if (recorder) replayRecord(recorder, game, input);
+}
+
+// One bot tick: the bot's inputs (recorded if asked), then step the game
+static void botTick(GameState* game, Replay* recorder, Bot* bot, float dt) {
+    SimInput inputs[2];
+    int count = botInputs(bot, game, inputs);
+    for (int i = 0; i < count; i++) {
+        sendInput(game, recorder, inputs[i]);
+    }
+    updateGame(game, dt);
+    simClearEvents(game);
+}
+
+// A bot picking up a game in progress, holding whatever key is down
+static Bot botForGame(const GameState* game, BotModel model) {
+    Bot bot = {model, game->moveLeft ? -1 : game->moveRight ? 1 : 0};
+    return bot;
+}
+
+// Rewind as far as the ring allows, re-run those ticks and check that the
+// game ends up byte-for-byte where it was
+static void checkRewind(SnapshotRing* ring, GameState* game, BotModel model, float dt) {
+    size_t size = snapshotSize(game);
+    uint8_t* before = malloc(size);
+    if (!before) return;
+    snapshotWrite(game, before);
+
+    double start = nowSeconds();
+    int steps = snapshotRingRewind(ring, game, ring->count - 1);
+    double rewindTime = nowSeconds() - start;
+
+    Bot bot = botForGame(game, model);
+    for (int i = 0; i < steps; i++) {
+        botTick(game, NULL, &bot, dt);
+    }
+    uint8_t* after = snapshotSize(game) == size ? malloc(size) : NULL;
+    if (after) snapshotWrite(game, after);
+    bool same = after && memcmp(before, after, size) == 0;
+
+    printf("Rewind: %d ticks in %.1f us, re-run %s\n", steps, rewindTime * 1e6,
+           same ? "matches" : "DIFFERS");
+    free(before);
+    free(after);
+}
+
+#define HEADLESS_PROFILE_TICKS 100000 // most recent ticks kept for --profile
+
+// Per-phase percentiles of the profiled ticks, in microseconds
+static void printProfile(Profiler* profiler) {
+    ProfileSummary summary;
+    profilerSummarize(profiler, &summary);
+    printf("Profile of the last %d ticks (us):  p50      p95      p99      max\n", summary.frames);
+    printf("  %-12s %8.2f %8.2f %8.2f %8.2f\n", "tick", summary.frame.p50 * 1e3,
+           summary.frame.p95 * 1e3, summary.frame.p99 * 1e3, summary.frame.max * 1e3);
+    for (int p = 0; p < PROFILE_PHASE_COUNT; p++) {
+        if (summary.phase[p].max <= 0.0) continue; // phases the headless run never enters
+        printf("  %-12s %8.2f %8.2f %8.2f %8.2f\n", profilePhaseName(p), summary.phase[p].p50 * 1e3,
+               summary.phase[p].p95 * 1e3, summary.phase[p].p99 * 1e3, summary.phase[p].max * 1e3);
+    }
+    printf("  allocations: %llu in %d of %d ticks\n", (unsigned long long)summary.allocations,
+           summary.allocatingFrames, summary.frames);
+}
+
+// Play a recording back repeat times with no pacing
+static int runReplay(const char* path, int repeat) {
+    static Replay replay;
+    static GameState game;
+    if (!replayLoad(&replay, path)) {
+        printf("Could not read replay: %s\n", path);
+        replayFree(&replay);
+        return 1;
+    }
+
+    long ticks = 0;
+    double start = nowSeconds();
+    for (int run = 0; run < repeat; run++) {
+        if (!replayStart(&replay, &game)) {
+            printf("Replay has an invalid number: %s\n", replay.digits);
+            replayFree(&replay);
+            return 1;
+        }
+        while (!replayDone(&replay, &game)) {
+            uint32_t before = game.tick;
+            replayApply(&replay, &game);
+            updateGame(&game, replay.tickSeconds);
+            simClearEvents(&game);
+            ticks += game.tick - before;
+        }
+    }
+    double elapsed = nowSeconds() - start;
+
+    printf("Replay: %s (seed %llu, %d inputs)\n", path, (unsigned long long)replay.seed, replay.count);
+    printf("Ticks: %ld in %.3f s (%.0f ticks/s)\n", ticks, elapsed, elapsed > 0 ? ticks / elapsed : 0.0);
+    printf("Final tick: %u | Level: %d | Score: %d | Lives: %d\n",
+           (unsigned)game.tick, game.level, game.score, game.player.lives);
+    replayFree(&replay);
+    simFree(&game);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    const char* number = "42";
+    ConversionType type = CONVERSION_DECIMAL;
+    long ticks = 100000;
+    float dt = SIM_TICK_SECONDS;
+    int storm = 0;
+    int particleScale = 1;
+    uint64_t seed = simClockSeed();
+    const char* recordPath = NULL;
+    const char* replayPath = NULL;
+    int repeat = 1;
+    int rewindSlots = 0;
+    bool autoplay = false;
+    const char* saveStatePath = NULL;
+    const char* loadStatePath = NULL;
+    const char* profilePath = NULL;
+    const char* tracePath = NULL;
+    bool countPerf = false;
+    long allocWarmup = -1;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--number") == 0 && i + 1 < argc) {
+            number = argv[++i];
+        } else if (strcmp(argv[i], "--type") == 0 && i + 1 < argc) {
+            const char* name = argv[++i];
+            if (strcmp(name, "oct") == 0) type = CONVERSION_OCTAL;
+            else if (strcmp(name, "hex") == 0) type = CONVERSION_HEXADECIMAL;
+            else type = CONVERSION_DECIMAL;
+        } else if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+            ticks = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--dt") == 0 && i + 1 < argc) {
+            dt = (float)atof(argv[++i]);
+        } else if (strcmp(argv[i], "--storm") == 0 && i + 1 < argc) {
+            storm = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--particles") == 0 && i + 1 < argc) {
+            particleScale = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--autoplay") == 0) {
+            autoplay = true;
+        } else if (strcmp(argv[i], "--rewind") == 0 && i + 1 < argc) {
+            rewindSlots = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--save-state") == 0 && i + 1 < argc) {
+            saveStatePath = argv[++i];
+        } else if (strcmp(argv[i], "--load-state") == 0 && i + 1 < argc) {
+            loadStatePath = argv[++i];
+        } else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+            profilePath = argv[++i];
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else if (strcmp(argv[i], "--counters") == 0) {
+            countPerf = true;
+        } else if (strcmp(argv[i], "--check-alloc") == 0 && i + 1 < argc) {
+            allocWarmup = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--check-bignum") == 0) {
+            // Regression check of the digit-string parsers, nothing else runs
+            int failures = bignumSelfTest();
+            printf("bignum check: %s\n", failures ? "FAILED" : "ok");
+            return failures ? 1 : 0;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (replayPath) {
+        return runReplay(replayPath, repeat);
+    }
+
+    // Game n of the run uses seed + n, so the whole run repeats from one seed
+    static GameState game;
+    simSetSeed(&game, seed);
+    if (!initGameFromDigits(&game, number, type)) {
+        printf("Invalid number for this conversion type: %s\n", number);
+        return 1;
+    }
+    simSetBitStorm(&game, storm);
+    simSetParticleScale(&game, particleScale);
+    if (loadStatePath) {
+        if (!snapshotLoad(&game, loadStatePath)) {
+            printf("Could not load state: %s\n", loadStatePath);
+            simFree(&game);
+            return 1;
+        }
+        // The run continues from the loaded game's seed, as if it had been
+        // passed with --seed
+        seed = game.seed;
+        printf("Loaded state: %s (tick %u)\n", loadStatePath, (unsigned)game.tick);
+    }
+
+    // --rewind keeps a snapshot of every tick of the current game
+    static SnapshotRing ring;
+    if (rewindSlots > 0 && !snapshotRingInit(&ring, rewindSlots)) {
+        printf("Could not allocate %d snapshot slots\n", rewindSlots);
+        return 1;
+    }
+    double snapshotTime = 0.0;
+
+    // --record captures the first game of the run
+    static Replay recorder;
+    Replay* recording = NULL;
+    if (recordPath) {
+        replayBegin(&recorder, &game, dt);
+        recording = &recorder;
+    }
+
+    // --profile times every tick's phases; the ring keeps the last
+    // HEADLESS_PROFILE_TICKS of them. --counters adds hardware counters
+    static Profiler profiler;
+    static PerfCounters counters;
+    bool profiling = profilePath || countPerf;
+    if (profiling) {
+        if (!profilerInit(&profiler, ticks < HEADLESS_PROFILE_TICKS ? (int)ticks : HEADLESS_PROFILE_TICKS)) {
+            printf("Could not allocate the profiler\n");
+            return 1;
+        }
+        profilerInstall(&profiler);
+    }
+    if (countPerf) {
+        if (perfOpen(&counters)) {
+            profilerAttachCounters(&profiler, &counters);
+        } else {
+            printf("Hardware counters unavailable (needs Linux perf events; see perf_event_paranoid)\n");
+        }
+    }
+
+    BotModel model = autoplay ? BOT_AUTOPLAY : BOT_SWEEP;
+    Bot bot = botForGame(&game, model);
+    long games = 1;
+    long levels = 0;
+    int bestScore = 0;
+    int peakBits = 0;
+    int peakParticles = 0;
+    double start = nowSeconds();
+
+    for (long tick = 0; tick < ticks; tick++) {
+        // --check-alloc: from here on the run must not allocate
+        if (tick == allocWarmup) allocResetCounts();
+        profileFrameBegin();
+        profileBegin(PROFILE_UPDATE);
+        botTick(&game, recording, &bot, dt);
+        profileEnd(PROFILE_UPDATE);
+        profileFrameEnd();
+        if (rewindSlots > 0) {
+            double pushStart = nowSeconds();
+            snapshotRingPush(&ring, &game);
+            snapshotTime += nowSeconds() - pushStart;
+        }
+        if (game.fallingBits.count > peakBits) peakBits = game.fallingBits.count;
+        if (game.particles.count > peakParticles) peakParticles = game.particles.count;
+
+        if (game.gameOver) {
+            if (recording) {
+                replayFinish(recording, &game);
+                recording = NULL;
+            }
+            levels += game.level - 1;
+            if (game.score > bestScore) bestScore = game.score;
+            simSetSeed(&game, seed + games);
+            initGameFromDigits(&game, number, type);
+            bot = botForGame(&game, model);
+            games++;
+            if (rewindSlots > 0) snapshotRingClear(&ring);
+        }
+    }
+    if (recording) {
+        replayFinish(recording, &game);
+    }
+
+    double elapsed = nowSeconds() - start;
+    levels += game.level - 1;
+    if (game.score > bestScore) bestScore = game.score;
+
+    printf("Seed: %llu\n", (unsigned long long)seed);
+    printf("Ticks: %ld in %.3f s (%.0f ticks/s)\n", ticks, elapsed, elapsed > 0 ? ticks / elapsed : 0.0);
+    printf("Games: %ld | Levels completed: %ld | Best score: %d\n", games, levels, bestScore);
+    printf("Peak live bits: %d | Peak particles: %d\n", peakBits, peakParticles);
+    if (rewindSlots > 0) {
+        printf("Snapshots: %d-slot ring, %.2f us per tick\n", rewindSlots,
+               ticks > 0 ? snapshotTime * 1e6 / ticks : 0.0);
+        checkRewind(&ring, &game, model, dt);
+        snapshotRingFree(&ring);
+    }
+    if (profiling) {
+        printProfile(&profiler);
+        if (profilePath && !profilerWriteCsv(&profiler, profilePath)) {
+            printf("Could not write profile: %s\n", profilePath);
+        }
+        profilerPrintCounters(&profiler, stdout);
+        if (countPerf) perfClose(&counters);
+        profilerFree(&profiler);
+    }
+    int status = 0;
+    if (allocWarmup >= 0) {
+        AllocTotals totals;
+        allocTotals(&totals);
+        if (allocWarmup >= ticks) {
+            printf("Allocation check skipped: warm-up covers all %ld ticks\n", ticks);
+        } else if (totals.allocations > 0) {
+            printf("FAIL: %llu allocations (%llu bytes) after warm-up tick %ld\n",
+                   (unsigned long long)totals.allocations, (unsigned long long)totals.bytes, allocWarmup);
+            allocReport(stdout);
+            status = 1;
+        } else {
+            printf("Steady state: no allocations after warm-up tick %ld\n", allocWarmup);
+        }
+    }
+    if (tracePath) {
+        if (traceWrite(tracePath)) printf("Wrote trace: %s\n", tracePath);
+        traceFree();
+    }
+    if (saveStatePath) {
+        if (snapshotSave(&game, saveStatePath)) {
+            printf("Saved state: %s (tick %u)\n", saveStatePath, (unsigned)game.tick);
+        } else {
+            printf("Could not save state: %s\n", saveStatePath);
+        }
+    }
+    if (recordPath) {
+        if (replaySave(&recorder, recordPath)) {
+            printf("Recorded first game: %s (%d inputs, %u ticks)\n", recordPath, recorder.count, (unsigned)recorder.endTick);
+        } else {
+            printf("Could not write replay: %s\n", recordPath);
+        }
+        replayFree(&recorder);
+    }
+    simFree(&game);
+    return status;
+}
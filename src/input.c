@@ -1,4 +1,3 @@
-#include <stdio.h>
 #include <termios.h>
 #include <unistd.h>
 #include <fcntl.h>
@@ -6,8 +5,8 @@
 static struct termios original_termios;
 static int terminal_initialized = 0;
 
-// Linux implementation
-int inputGet(){
+// Raw, non-blocking keyboard: no line buffering, no echo
+void inputInit(){
     static struct termios new_termios;
     
     if (!terminal_initialized) {
@@ -18,12 +17,6 @@ int inputGet(){
         fcntl(STDIN_FILENO, F_SETFL, O_NONBLOCK);
         terminal_initialized = 1;
     }
-    
-    int ch = getchar();
-    if (ch == EOF) {
-        return -1;  // No key pressed
-    }
-    return ch;
 }
 
 void inputCleanup(){
@@ -32,4 +25,4 @@ void inputCleanup(){
         fcntl(STDIN_FILENO, F_SETFL, 0);
         terminal_initialized = 0;
     }
-}
\ No newline at end of file
+}
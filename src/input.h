@@ -1,7 +1,7 @@
 #ifndef INPUT_H
 #define INPUT_H
 
-int inputGet();
+void inputInit();
 void inputCleanup();
 
-#endif
\ No newline at end of file
+#endif
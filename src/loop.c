@@ -0,0 +1,64 @@
+#define _POSIX_C_SOURCE 200809L
+#include <errno.h>
+#include <poll.h>
+#include <stdint.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include "loop.h"
+
+bool loopInit(TickLoop* loop, int inputFd, double ticksPerSecond){
+    loop->inputFd = inputFd;
+    loop->keyCount = 0;
+    loop->timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (loop->timerFd < 0) return false;
+
+    long long period = (long long)(1e9 / (ticksPerSecond > 0 ? ticksPerSecond : 1.0));
+    if (period < 1) period = 1;
+    struct itimerspec schedule;
+    schedule.it_interval.tv_sec = period / 1000000000;
+    schedule.it_interval.tv_nsec = period % 1000000000;
+    schedule.it_value = schedule.it_interval;
+    if (timerfd_settime(loop->timerFd, 0, &schedule, NULL) != 0) {
+        close(loop->timerFd);
+        loop->timerFd = -1;
+        return false;
+    }
+    return true;
+}
+
+int loopWait(TickLoop* loop){
+    loop->keyCount = 0;
+    for (;;) {
+        struct pollfd fds[2] = {
+            {loop->timerFd, POLLIN, 0},
+            {loop->inputFd, POLLIN, 0}, // ignored by poll while negative
+        };
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+
+        if (fds[1].revents) {
+            ssize_t got = read(loop->inputFd, loop->keys, sizeof(loop->keys));
+            if (got > 0) {
+                loop->keyCount = (int)got;
+            } else if (got == 0 || (errno != EAGAIN && errno != EINTR)) {
+                loop->inputFd = -1; // closed; keep ticking
+            }
+        }
+
+        int ticks = 0;
+        if (fds[0].revents & POLLIN) {
+            uint64_t expirations = 0;
+            if (read(loop->timerFd, &expirations, sizeof(expirations)) == sizeof(expirations)) {
+                ticks = expirations > LOOP_MAX_CATCHUP ? LOOP_MAX_CATCHUP : (int)expirations;
+            }
+        }
+        if (ticks > 0 || loop->keyCount > 0) return ticks;
+    }
+}
+
+void loopFree(TickLoop* loop){
+    if (loop->timerFd >= 0) close(loop->timerFd);
+    loop->timerFd = -1;
+}
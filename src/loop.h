@@ -0,0 +1,28 @@
+#ifndef LOOP_H
+#define LOOP_H
+
+#include <stdbool.h>
+
+// Console event loop: one poll() over the keyboard and a periodic timerfd.
+// Keystrokes wake it at once; ticks follow the timer's fixed schedule, so
+// time spent drawing never shifts the cadence. Ticks missed while the
+// process was busy are reported together (up to LOOP_MAX_CATCHUP) so the
+// caller can catch up.
+
+#define LOOP_MAX_CATCHUP 5
+#define LOOP_MAX_KEYS 64
+
+typedef struct {
+    int timerFd;
+    int inputFd;   // -1 once the input reaches end of file
+    char keys[LOOP_MAX_KEYS];
+    int keyCount;  // keys read by the last loopWait
+} TickLoop;
+
+bool loopInit(TickLoop* loop, int inputFd, double ticksPerSecond);
+// Block until input or a tick; returns the ticks due (0 when woken only by
+// keys), or -1 on error
+int loopWait(TickLoop* loop);
+void loopFree(TickLoop* loop);
+
+#endif
@@ -1,18 +1,114 @@
+#define _DEFAULT_SOURCE
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
 #include "game.h"
 #include "input.h"
+#include "loop.h"
+
+// Scripted player for load runs: walk toward the falling bit
+static int trackBit(const ConsoleGame* game){
+    if (game->playerpos+1 < game->currentBitX) return 'd';
+    if (game->playerpos > game->currentBitX) return 'a';
+    return -1;
+}
+
+// Step many sessions in lockstep as fast as possible
+static int runLoad(int sessions, int number){
+    ConsoleGame* games = calloc(sessions, sizeof(ConsoleGame));
+    if (!games) {
+        printf("Out of memory\n");
+        return 1;
+    }
+    for (int i = 0; i < sessions; i++) gameInit(&games[i], number + i);
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    long steps = 0;
+    long totalScore = 0;
+    int running = sessions;
+    while (running > 0) {
+        running = 0;
+        for (int i = 0; i < sessions; i++) {
+            if (gameIsOver(&games[i])) continue;
+            gameUpdate(&games[i], trackBit(&games[i]));
+            steps++;
+            if (gameIsOver(&games[i])) totalScore += gameGetScore(&games[i]);
+            else running++;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double elapsed = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    printf("Sessions: %d | Steps: %ld in %.3f s (%.0f steps/s) | Mean score: %.1f\n",
+           sessions, steps, elapsed, elapsed > 0 ? steps / elapsed : 0.0, (double)totalScore / sessions);
+    free(games);
+    return 0;
+}
+
+int main(int argc, char* argv[]){
+    int width = SCREEN_WIDTH, height = SCREEN_HEIGHT;
+    double rate = 1000.0 / GAME_STEP_MS;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--load") == 0 && i + 1 < argc) {
+            // --load N [START] steps N sessions (numbers START, START+1, ...) headless
+            int sessions = atoi(argv[i + 1]);
+            return runLoad(sessions > 0 ? sessions : 1, i + 2 < argc ? atoi(argv[i + 2]) : 1);
+        } else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc &&
+                   sscanf(argv[i + 1], "%dx%d", &width, &height) == 2) {
+            // --size WxH plays on a bigger (or smaller) board
+            i++;
+        } else if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc && atof(argv[i + 1]) > 0) {
+            // --rate HZ sets the tick rate
+            rate = atof(argv[++i]);
+        } else {
+            printf("Usage: %s [--size WxH] [--rate HZ] | --load SESSIONS [START]\n", argv[0]);
+            return 1;
+        }
+    }
 
-int main(){
     int startNumber;
     printf("Enter a Number: ");
     scanf("%d",&startNumber);
 
-    gameInit(startNumber);
-    while (!gameIsOver()){
-        gameUpdate();
-        gameDraw();
+    ConsoleGame game;
+    gameInitBoard(&game, startNumber, width, height);
+    TermRenderer term;
+    int frameWidth, frameHeight;
+    gameFrameSize(&game, &frameWidth, &frameHeight);
+    if (!termInit(&term, frameWidth, frameHeight)) {
+        printf("Out of memory\n");
+        return 1;
+    }
+    TickLoop loop;
+    if (!loopInit(&loop, STDIN_FILENO, rate)) {
+        printf("Could not create the tick timer\n");
+        termFree(&term);
+        return 1;
+    }
+    inputInit();
+    fflush(stdout); // frames bypass stdio
+    gameRender(&game, &term);
+    termPresent(&term, STDOUT_FILENO);
+    // Keys move the player the moment they arrive; drops follow the timer
+    while (!gameIsOver(&game)){
+        int ticks = loopWait(&loop);
+        if (ticks < 0) break;
+        for (int i = 0; i < loop.keyCount && !gameIsOver(&game); i++) {
+            gameHandleKey(&game, loop.keys[i]);
+        }
+        for (int i = 0; i < ticks && !gameIsOver(&game); i++) {
+            gameTick(&game);
+        }
+        gameRender(&game, &term);
+        termPresent(&term, STDOUT_FILENO);
     }
+    loopFree(&loop);
+    termRestore(&term, STDOUT_FILENO);
+    termFree(&term);
     inputCleanup();
-    printf("Game over! Your Score: %d\n",gameGetScore());
+    printf("Game over! Your Score: %d\n",gameGetScore(&game));
     return 0;
-}
\ No newline at end of file
+}
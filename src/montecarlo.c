@@ -0,0 +1,113 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include "batch.h"
+#include "workpool.h"
+
+// Monte Carlo runner: plays many independent games with the autoplay bot
+// on the work-stealing pool and reports throughput plus level and score
+// distributions. Game n uses seed + n and results are stored by game
+// index, so the report does not depend on the thread count.
+
+#define DEFAULT_GAMES 1000
+#define HISTOGRAM_WIDTH 40
+
+typedef struct {
+    BatchOptions options;
+    GameResult* results;
+    GameState* workerGames; // one per worker, pools reused across games
+} Runner;
+
+static void runGame(void* context, int task, int worker) {
+    Runner* runner = context;
+    batchPlayGame(&runner->workerGames[worker], &runner->options, task, &runner->results[task]);
+}
+
+static void printReport(const Runner* runner, long threads, double elapsed) {
+    int games = runner->options.games;
+    long long totalTicks = 0;
+    long long totalScore = 0;
+    int capped = 0;
+    int maxLevel = 1;
+    int* scores = malloc((size_t)games * sizeof(int));
+    if (!scores) return;
+    for (int n = 0; n < games; n++) {
+        const GameResult* result = &runner->results[n];
+        totalTicks += result->ticks;
+        totalScore += result->score;
+        if (result->capped) capped++;
+        if (result->level > maxLevel) maxLevel = result->level;
+        scores[n] = result->score;
+    }
+    qsort(scores, games, sizeof(int), batchCompareInts);
+
+    printf("Games: %d on %ld threads in %.3f s (%.0f games/s, %.0f ticks/s)\n", games, threads, elapsed,
+           elapsed > 0 ? games / elapsed : 0.0, elapsed > 0 ? totalTicks / elapsed : 0.0);
+    printf("Game length: mean %.1f s of play | %d of %d hit the %u tick limit\n",
+           (double)totalTicks / games / SIM_TICK_RATE, capped, games, (unsigned)runner->options.maxTicks);
+    printf("Score: mean %.1f | min %d | p10 %d | p50 %d | p90 %d | max %d\n",
+           (double)totalScore / games, scores[0], scores[games / 10], scores[games / 2],
+           scores[games * 9 / 10], scores[games - 1]);
+    free(scores);
+
+    int* levels = calloc((size_t)maxLevel + 1, sizeof(int));
+    if (!levels) return;
+    int mostCommon = 0;
+    for (int n = 0; n < games; n++) {
+        int count = ++levels[runner->results[n].level];
+        if (count > mostCommon) mostCommon = count;
+    }
+    printf("Level reached:\n");
+    for (int level = 1; level <= maxLevel; level++) {
+        if (levels[level] == 0) continue;
+        int bar = levels[level] * HISTOGRAM_WIDTH / mostCommon;
+        printf("  %3d: %7d %5.1f%% ", level, levels[level], 100.0 * levels[level] / games);
+        for (int i = 0; i < bar; i++) putchar('#');
+        putchar('\n');
+    }
+    free(levels);
+}
+
+static void printUsage(const char* program) {
+    printf("Usage: %s [options]\n", program);
+    printf("  --games N        games to play (default: %d)\n", DEFAULT_GAMES);
+    printf("  --threads N      worker threads (default: all cores)\n");
+    printf("  --number N       starting number (default: 42)\n");
+    printf("  --type dec|oct|hex\n");
+    printf("  --seed N         game n uses seed + n (default: from the clock)\n");
+    printf("  --max-minutes N  cut games off after N minutes of play (default: %d)\n", BATCH_DEFAULT_MAX_MINUTES);
+}
+
+int main(int argc, char* argv[]) {
+    static Runner runner;
+    BatchOptions* options = &runner.options;
+    batchDefaultOptions(options, DEFAULT_GAMES);
+    for (int i = 1; i < argc; i++) {
+        if (!batchParseOption(options, argc, argv, &i)) {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (!batchCheckOptions(options)) return 1;
+
+    runner.results = calloc((size_t)options->games, sizeof(GameResult));
+    runner.workerGames = calloc((size_t)options->threads, sizeof(GameState));
+    if (!runner.results || !runner.workerGames) {
+        printf("bqmonte: out of memory\n");
+        return 1;
+    }
+
+    double start = batchNowSeconds();
+    int started = workPoolRun(options->games, (int)options->threads, runGame, &runner);
+    double elapsed = batchNowSeconds() - start;
+
+    printf("Seed: %llu | Number: %s\n", (unsigned long long)options->seed, options->number);
+    printReport(&runner, started, elapsed);
+
+    for (long i = 0; i < options->threads; i++) {
+        simFree(&runner.workerGames[i]);
+    }
+    free(runner.workerGames);
+    free(runner.results);
+    return 0;
+}
@@ -0,0 +1,132 @@
+#include "sim.h"
+#include "trace.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define PARTICLES_SSE2 1
+#endif
+
+// Particle effects. Positions, velocities, life, size and color are
+// separate streams in ParticlePool; the integrator runs four particles per
+// SSE2 step (scalar elsewhere) and dead particles are compacted in a single
+// pass afterwards instead of being swapped out one at a time.
+
+#define PARTICLE_GRAVITY 3000.0f // pixels per second squared
+#define PARTICLE_FADE_RATE 2.0f  // life lost per second (0.5 second lifetime)
+
+// Particles spawned per effect are multiplied by the burst scale (stress runs)
+void simSetParticleScale(GameState* game, int scale) {
+    game->particleScale = scale > 1 ? scale : 1;
+}
+
+void spawnParticles(GameState* game, float x, float y, ParticleType type, int count) {
+    ParticlePool* particles = &game->particles;
+    Rng* rng = &game->cosmeticRng;
+    if (game->particleScale > 1) count *= game->particleScale;
+    if (!particlePoolReserve(particles, count)) return;
+
+    for (int n = 0; n < count; n++) {
+        int i = particles->count++;
+        particles->x[i] = x;
+        particles->y[i] = y;
+        particles->life[i] = 1.0f;
+        float size = 2.0f + rngBelow(rng, 4);
+
+        // Set particle properties based on type
+        switch (type) {
+            case PARTICLE_BIT_COLLECT:
+                particles->color[i] = (Color){0, 255, 100, 255}; // Green
+                particles->vx[i] = rngRange(rng, -100, 99) * 6.0f;
+                particles->vy[i] = rngRange(rng, -150, -51) * 6.0f;
+                break;
+            case PARTICLE_WRONG_BIT:
+                particles->color[i] = (Color){255, 50, 50, 255}; // Red
+                particles->vx[i] = rngRange(rng, -150, 149) * 6.0f;
+                particles->vy[i] = rngRange(rng, -250, -51) * 6.0f;
+                size *= 1.5f; // Larger particles for wrong bits
+                break;
+            case PARTICLE_LEVEL_COMPLETE:
+                particles->color[i] = (Color){255, 215, 0, 255}; // Gold
+                particles->vx[i] = rngRange(rng, -200, 199) * 6.0f;
+                particles->vy[i] = rngRange(rng, -400, -101) * 6.0f;
+                size *= 2.0f; // Larger particles for level complete
+                break;
+            case PARTICLE_POWERUP:
+                particles->color[i] = (Color){255, 255, 0, 255}; // Yellow
+                particles->vx[i] = rngRange(rng, -75, 74) * 6.0f;
+                particles->vy[i] = rngRange(rng, -200, -51) * 6.0f;
+                break;
+        }
+        particles->size[i] = size;
+    }
+}
+
+// Exact for constant gravity, so the path doesn't depend on the tick length
+static void integrateParticles(float* restrict x, float* restrict y,
+                               const float* restrict vx, float* restrict vy,
+                               float* restrict life, int count, float deltaTime) {
+    const float gravityStep = PARTICLE_GRAVITY * deltaTime;
+    const float gravityDrop = 0.5f * PARTICLE_GRAVITY * deltaTime * deltaTime;
+    const float fade = PARTICLE_FADE_RATE * deltaTime;
+    int i = 0;
+
+#ifdef PARTICLES_SSE2
+    const __m128 dt4 = _mm_set1_ps(deltaTime);
+    const __m128 step4 = _mm_set1_ps(gravityStep);
+    const __m128 drop4 = _mm_set1_ps(gravityDrop);
+    const __m128 fade4 = _mm_set1_ps(fade);
+    for (; i + 4 <= count; i += 4) {
+        __m128 px = _mm_loadu_ps(x + i);
+        __m128 py = _mm_loadu_ps(y + i);
+        __m128 pvx = _mm_loadu_ps(vx + i);
+        __m128 pvy = _mm_loadu_ps(vy + i);
+        __m128 pl = _mm_loadu_ps(life + i);
+
+        px = _mm_add_ps(px, _mm_mul_ps(pvx, dt4));
+        py = _mm_add_ps(py, _mm_add_ps(_mm_mul_ps(pvy, dt4), drop4));
+        pvy = _mm_add_ps(pvy, step4);
+        pl = _mm_sub_ps(pl, fade4);
+
+        _mm_storeu_ps(x + i, px);
+        _mm_storeu_ps(y + i, py);
+        _mm_storeu_ps(vy + i, pvy);
+        _mm_storeu_ps(life + i, pl);
+    }
+#endif
+
+    for (; i < count; i++) {
+        x[i] += vx[i] * deltaTime;
+        y[i] += vy[i] * deltaTime + gravityDrop;
+        vy[i] += gravityStep;
+        life[i] -= fade;
+    }
+}
+
+// Keep live particles in order, dropping dead ones in one sweep
+static void compactParticles(ParticlePool* particles) {
+    int live = 0;
+    for (int i = 0; i < particles->count; i++) {
+        if (particles->life[i] <= 0.0f) continue;
+        if (live != i) {
+            particles->x[live] = particles->x[i];
+            particles->y[live] = particles->y[i];
+            particles->vx[live] = particles->vx[i];
+            particles->vy[live] = particles->vy[i];
+            particles->life[live] = particles->life[i];
+            particles->size[live] = particles->size[i];
+            particles->color[live] = particles->color[i];
+        }
+        live++;
+    }
+    particles->count = live;
+}
+
+void updateParticles(GameState* game, float deltaTime) {
+    TRACE_FUNCTION();
+    ParticlePool* particles = &game->particles;
+    if (particles->count == 0) return;
+
+    integrateParticles(particles->x, particles->y, particles->vx, particles->vy,
+                       particles->life, particles->count, deltaTime);
+    compactParticles(particles);
+}
@@ -0,0 +1,112 @@
+#define _GNU_SOURCE
+#include "perf.h"
+#include <string.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+static const char* counterNames[PERF_COUNTER_COUNT] = {
+    "cycles", "instructions", "cache-misses", "branch-misses"
+};
+
+const char* perfCounterName(PerfCounter counter) {
+    return counter >= 0 && counter < PERF_COUNTER_COUNT ? counterNames[counter] : "?";
+}
+
+bool perfAvailable(const PerfCounters* counters, PerfCounter counter) {
+    return counters->slot[counter] >= 0;
+}
+
+#ifdef __linux__
+
+static const uint64_t counterConfigs[PERF_COUNTER_COUNT] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES
+};
+
+static int openCounter(uint64_t config, int groupFd) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = groupFd < 0; // the leader starts the whole group
+    attr.exclude_kernel = 1;      // our code, not the syscalls that read it
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0);
+}
+
+bool perfOpen(PerfCounters* counters) {
+    counters->groupFd = -1;
+    counters->members = 0;
+    for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+        int fd = openCounter(counterConfigs[c], counters->groupFd);
+        counters->fds[c] = fd;
+        counters->slot[c] = fd >= 0 ? counters->members++ : -1;
+        if (fd >= 0 && counters->groupFd < 0) counters->groupFd = fd;
+    }
+    if (counters->groupFd < 0) return false;
+    ioctl(counters->groupFd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(counters->groupFd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    return true;
+}
+
+void perfClose(PerfCounters* counters) {
+    for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+        if (counters->fds[c] >= 0) close(counters->fds[c]);
+        counters->fds[c] = -1;
+        counters->slot[c] = -1;
+    }
+    counters->groupFd = -1;
+    counters->members = 0;
+}
+
+void perfRead(const PerfCounters* counters, uint64_t values[PERF_COUNTER_COUNT]) {
+    // nr, time enabled, time running, then one value per member
+    uint64_t buffer[3 + PERF_COUNTER_COUNT];
+    memset(values, 0, PERF_COUNTER_COUNT * sizeof(uint64_t));
+    if (counters->groupFd < 0) return;
+    ssize_t expected = (ssize_t)((3 + counters->members) * sizeof(uint64_t));
+    if (read(counters->groupFd, buffer, sizeof(buffer)) < expected) return;
+
+    uint64_t enabled = buffer[1];
+    uint64_t running = buffer[2];
+    for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+        if (counters->slot[c] < 0) continue;
+        uint64_t value = buffer[3 + counters->slot[c]];
+        if (running > 0 && running < enabled) {
+            value = (uint64_t)((double)value * enabled / running);
+        }
+        values[c] = value;
+    }
+}
+
+#else
+
+bool perfOpen(PerfCounters* counters) {
+    counters->groupFd = -1;
+    counters->members = 0;
+    for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+        counters->fds[c] = -1;
+        counters->slot[c] = -1;
+    }
+    return false;
+}
+
+void perfClose(PerfCounters* counters) {
+    (void)counters;
+}
+
+void perfRead(const PerfCounters* counters, uint64_t values[PERF_COUNTER_COUNT]) {
+    (void)counters;
+    memset(values, 0, PERF_COUNTER_COUNT * sizeof(uint64_t));
+}
+
+#endif
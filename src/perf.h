@@ -0,0 +1,36 @@
+#ifndef PERF_H
+#define PERF_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Hardware performance counters for the calling thread, through Linux
+// perf_event_open. The counters are opened as one group so a single read
+// returns all of them for the same interval; counters the CPU, kernel or
+// VM does not offer are left out and read as zero. Elsewhere (or when
+// perf_event_paranoid forbids it) perfOpen fails and nothing is counted.
+
+typedef enum {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_CACHE_MISSES,
+    PERF_BRANCH_MISSES,
+    PERF_COUNTER_COUNT
+} PerfCounter;
+
+typedef struct {
+    int groupFd;
+    int fds[PERF_COUNTER_COUNT];
+    int slot[PERF_COUNTER_COUNT]; // position in the group read, -1 if not open
+    int members;
+} PerfCounters;
+
+bool perfOpen(PerfCounters* counters);
+void perfClose(PerfCounters* counters);
+bool perfAvailable(const PerfCounters* counters, PerfCounter counter);
+const char* perfCounterName(PerfCounter counter);
+
+// Running totals since perfOpen, scaled up if the kernel had to multiplex
+void perfRead(const PerfCounters* counters, uint64_t values[PERF_COUNTER_COUNT]);
+
+#endif
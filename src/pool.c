@@ -0,0 +1,153 @@
+#include "sim.h"
+#include "alloc.h"
+#include <stdlib.h>
+
+// Resize one stream; on failure the old allocation is left untouched
+static bool growStream(void** stream, size_t elementSize, int capacity) {
+    void* grown = TRACKED_REALLOC(*stream, (size_t)capacity * elementSize);
+    if (!grown) return false;
+    *stream = grown;
+    return true;
+}
+
+static int nextCapacity(int capacity, int needed) {
+    int next = capacity > 0 ? capacity : POOL_INITIAL_CAPACITY;
+    while (next < needed) next *= 2;
+    return next;
+}
+
+static bool bitPoolReserve(BitPool* pool, int needed) {
+    if (needed <= pool->capacity) return true;
+    int capacity = nextCapacity(pool->capacity, needed);
+    if (!growStream((void**)&pool->x, sizeof(float), capacity) ||
+        !growStream((void**)&pool->y, sizeof(float), capacity) ||
+        !growStream((void**)&pool->prevX, sizeof(float), capacity) ||
+        !growStream((void**)&pool->prevY, sizeof(float), capacity) ||
+        !growStream((void**)&pool->speed, sizeof(float), capacity) ||
+        !growStream((void**)&pool->value, sizeof(uint8_t), capacity)) {
+        return false;
+    }
+    pool->capacity = capacity;
+    return true;
+}
+
+static bool powerUpPoolReserve(PowerUpPool* pool, int needed) {
+    if (needed <= pool->capacity) return true;
+    int capacity = nextCapacity(pool->capacity, needed);
+    if (!growStream((void**)&pool->x, sizeof(float), capacity) ||
+        !growStream((void**)&pool->y, sizeof(float), capacity) ||
+        !growStream((void**)&pool->prevX, sizeof(float), capacity) ||
+        !growStream((void**)&pool->prevY, sizeof(float), capacity) ||
+        !growStream((void**)&pool->speed, sizeof(float), capacity) ||
+        !growStream((void**)&pool->type, sizeof(uint8_t), capacity) ||
+        !growStream((void**)&pool->duration, sizeof(float), capacity)) {
+        return false;
+    }
+    pool->capacity = capacity;
+    return true;
+}
+
+bool particlePoolReserve(ParticlePool* pool, int count) {
+    int needed = pool->count + count;
+    if (needed <= pool->capacity) return true;
+    int capacity = nextCapacity(pool->capacity, needed);
+    if (!growStream((void**)&pool->x, sizeof(float), capacity) ||
+        !growStream((void**)&pool->y, sizeof(float), capacity) ||
+        !growStream((void**)&pool->vx, sizeof(float), capacity) ||
+        !growStream((void**)&pool->vy, sizeof(float), capacity) ||
+        !growStream((void**)&pool->life, sizeof(float), capacity) ||
+        !growStream((void**)&pool->size, sizeof(float), capacity) ||
+        !growStream((void**)&pool->color, sizeof(Color), capacity)) {
+        return false;
+    }
+    pool->capacity = capacity;
+    return true;
+}
+
+int bitPoolAdd(BitPool* pool) {
+    if (!bitPoolReserve(pool, pool->count + 1)) return -1;
+    return pool->count++;
+}
+
+int powerUpPoolAdd(PowerUpPool* pool) {
+    if (!powerUpPoolReserve(pool, pool->count + 1)) return -1;
+    return pool->count++;
+}
+
+int particlePoolAdd(ParticlePool* pool) {
+    if (!particlePoolReserve(pool, 1)) return -1;
+    return pool->count++;
+}
+
+// Set the live count, growing the streams if needed (snapshot restore)
+bool bitPoolResize(BitPool* pool, int count) {
+    if (!bitPoolReserve(pool, count)) return false;
+    pool->count = count;
+    return true;
+}
+
+bool powerUpPoolResize(PowerUpPool* pool, int count) {
+    if (!powerUpPoolReserve(pool, count)) return false;
+    pool->count = count;
+    return true;
+}
+
+bool particlePoolResize(ParticlePool* pool, int count) {
+    pool->count = 0;
+    if (!particlePoolReserve(pool, count)) return false;
+    pool->count = count;
+    return true;
+}
+
+void bitPoolRemove(BitPool* pool, int index) {
+    int last = --pool->count;
+    pool->x[index] = pool->x[last];
+    pool->y[index] = pool->y[last];
+    pool->prevX[index] = pool->prevX[last];
+    pool->prevY[index] = pool->prevY[last];
+    pool->speed[index] = pool->speed[last];
+    pool->value[index] = pool->value[last];
+}
+
+void powerUpPoolRemove(PowerUpPool* pool, int index) {
+    int last = --pool->count;
+    pool->x[index] = pool->x[last];
+    pool->y[index] = pool->y[last];
+    pool->prevX[index] = pool->prevX[last];
+    pool->prevY[index] = pool->prevY[last];
+    pool->speed[index] = pool->speed[last];
+    pool->type[index] = pool->type[last];
+    pool->duration[index] = pool->duration[last];
+}
+
+void bitPoolFree(BitPool* pool) {
+    TRACKED_FREE(pool->x);
+    TRACKED_FREE(pool->y);
+    TRACKED_FREE(pool->prevX);
+    TRACKED_FREE(pool->prevY);
+    TRACKED_FREE(pool->speed);
+    TRACKED_FREE(pool->value);
+    *pool = (BitPool){0};
+}
+
+void powerUpPoolFree(PowerUpPool* pool) {
+    TRACKED_FREE(pool->x);
+    TRACKED_FREE(pool->y);
+    TRACKED_FREE(pool->prevX);
+    TRACKED_FREE(pool->prevY);
+    TRACKED_FREE(pool->speed);
+    TRACKED_FREE(pool->type);
+    TRACKED_FREE(pool->duration);
+    *pool = (PowerUpPool){0};
+}
+
+void particlePoolFree(ParticlePool* pool) {
+    TRACKED_FREE(pool->x);
+    TRACKED_FREE(pool->y);
+    TRACKED_FREE(pool->vx);
+    TRACKED_FREE(pool->vy);
+    TRACKED_FREE(pool->life);
+    TRACKED_FREE(pool->size);
+    TRACKED_FREE(pool->color);
+    *pool = (ParticlePool){0};
+}
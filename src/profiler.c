@@ -0,0 +1,238 @@
+#define _POSIX_C_SOURCE 200809L
+#include "profiler.h"
+#include "alloc.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+static Profiler* installed = NULL;
+
+static const char* phaseNames[PROFILE_PHASE_COUNT] = {
+    "events", "update", "collisions", "particles", "hud_text", "entities", "present"
+};
+
+bool profilerInit(Profiler* profiler, int capacity) {
+    memset(profiler, 0, sizeof(*profiler));
+    if (capacity < 1) capacity = 1;
+    profiler->frames = calloc((size_t)capacity, sizeof(ProfileFrame));
+    profiler->scratch = malloc((size_t)capacity * sizeof(double));
+    if (!profiler->frames || !profiler->scratch) {
+        profilerFree(profiler);
+        return false;
+    }
+    profiler->capacity = capacity;
+    return true;
+}
+
+void profilerFree(Profiler* profiler) {
+    if (installed == profiler) installed = NULL;
+    free(profiler->frames);
+    free(profiler->scratch);
+    profiler->frames = NULL;
+    profiler->scratch = NULL;
+    profiler->capacity = 0;
+    profiler->count = 0;
+}
+
+void profilerInstall(Profiler* profiler) {
+    installed = profiler;
+}
+
+void profilerAttachCounters(Profiler* profiler, PerfCounters* counters) {
+    profiler->counters = counters;
+    memset(profiler->phaseCounts, 0, sizeof(profiler->phaseCounts));
+    memset(profiler->phaseEntries, 0, sizeof(profiler->phaseEntries));
+}
+
+Profiler* profilerInstalled(void) {
+    return installed;
+}
+
+uint64_t profilerNow(void) {
+#ifdef _WIN32
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    if (frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (uint64_t)((double)counter.QuadPart * 1e9 / (double)frequency.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+const char* profilePhaseName(ProfilePhase phase) {
+    return phase >= 0 && phase < PROFILE_PHASE_COUNT ? phaseNames[phase] : "?";
+}
+
+void profileFrameBegin(void) {
+    Profiler* profiler = installed;
+    if (!profiler) return;
+    memset(&profiler->current, 0, sizeof(profiler->current));
+    profiler->depth = 0;
+    profiler->inFrame = true;
+    AllocTotals totals;
+    allocResetPeak();
+    allocTotals(&totals);
+    profiler->frameAllocations = totals.allocations;
+    profiler->frameBytes = totals.bytes;
+    profiler->frameStart = profilerNow();
+}
+
+void profileFrameEnd(void) {
+    Profiler* profiler = installed;
+    if (!profiler || !profiler->inFrame) return;
+    // A phase left open (an early return) is closed at the frame boundary
+    while (profiler->depth > 0) {
+        profileEnd(profiler->stack[profiler->depth - 1]);
+    }
+    profiler->current.total = profilerNow() - profiler->frameStart;
+    AllocTotals totals;
+    allocTotals(&totals);
+    profiler->current.allocations = (uint32_t)(totals.allocations - profiler->frameAllocations);
+    profiler->current.allocatedBytes = totals.bytes - profiler->frameBytes;
+    profiler->current.peakLiveBytes = totals.peakBytes;
+    profiler->frames[profiler->next] = profiler->current;
+    profiler->next = (profiler->next + 1) % profiler->capacity;
+    if (profiler->count < profiler->capacity) profiler->count++;
+    profiler->frameIndex++;
+    profiler->inFrame = false;
+}
+
+void profileBegin(ProfilePhase phase) {
+    Profiler* profiler = installed;
+    if (!profiler || !profiler->inFrame || profiler->depth >= PROFILE_MAX_DEPTH) return;
+    int depth = profiler->depth++;
+    profiler->stack[depth] = phase;
+    profiler->nested[depth] = 0;
+    if (profiler->counters) {
+        memset(profiler->nestedCounts[depth], 0, sizeof(profiler->nestedCounts[depth]));
+        perfRead(profiler->counters, profiler->startedCounts[depth]);
+    }
+    profiler->started[depth] = profilerNow();
+}
+
+void profileEnd(ProfilePhase phase) {
+    Profiler* profiler = installed;
+    if (!profiler || profiler->depth == 0) return;
+    int depth = profiler->depth - 1;
+    if (profiler->stack[depth] != phase) return; // unbalanced; ignore
+    uint64_t elapsed = profilerNow() - profiler->started[depth];
+    if (profiler->counters) {
+        uint64_t counts[PERF_COUNTER_COUNT];
+        perfRead(profiler->counters, counts);
+        for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+            uint64_t spent = counts[c] - profiler->startedCounts[depth][c];
+            uint64_t own = spent - profiler->nestedCounts[depth][c];
+            // Multiplexing scale-up can make a child outgrow its parent
+            profiler->phaseCounts[phase][c] += own <= spent ? own : 0;
+            if (depth > 0) profiler->nestedCounts[depth - 1][c] += spent;
+        }
+        profiler->phaseEntries[phase]++;
+    }
+    profiler->current.phase[phase] += elapsed - profiler->nested[depth];
+    if (depth > 0) profiler->nested[depth - 1] += elapsed;
+    profiler->depth = depth;
+}
+
+const ProfileFrame* profilerFrame(const Profiler* profiler, int age) {
+    if (age < 0 || age >= profiler->count) return NULL;
+    int index = (profiler->next - 1 - age + profiler->capacity) % profiler->capacity;
+    return &profiler->frames[index];
+}
+
+static int compareDouble(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentiles of one column of the ring (phase, or
+// PROFILE_PHASE_COUNT for the frame total)
+static ProfilePercentiles percentiles(Profiler* profiler, int phase) {
+    ProfilePercentiles result = {0.0, 0.0, 0.0, 0.0};
+    int n = profiler->count;
+    if (n == 0) return result;
+    for (int i = 0; i < n; i++) {
+        const ProfileFrame* frame = &profiler->frames[i];
+        uint64_t ns = phase == PROFILE_PHASE_COUNT ? frame->total : frame->phase[phase];
+        profiler->scratch[i] = ns / 1e6;
+    }
+    qsort(profiler->scratch, (size_t)n, sizeof(double), compareDouble);
+    result.p50 = profiler->scratch[(n - 1) * 50 / 100];
+    result.p95 = profiler->scratch[(n - 1) * 95 / 100];
+    result.p99 = profiler->scratch[(n - 1) * 99 / 100];
+    result.max = profiler->scratch[n - 1];
+    return result;
+}
+
+void profilerSummarize(Profiler* profiler, ProfileSummary* summary) {
+    summary->frames = profiler->count;
+    summary->allocations = 0;
+    summary->allocatingFrames = 0;
+    for (int i = 0; i < profiler->count; i++) {
+        summary->allocations += profiler->frames[i].allocations;
+        if (profiler->frames[i].allocations > 0) summary->allocatingFrames++;
+    }
+    summary->frame = percentiles(profiler, PROFILE_PHASE_COUNT);
+    for (int p = 0; p < PROFILE_PHASE_COUNT; p++) {
+        summary->phase[p] = percentiles(profiler, p);
+    }
+}
+
+// One row per recorded frame, oldest first, times in milliseconds
+bool profilerWriteCsv(const Profiler* profiler, const char* path) {
+    FILE* file = fopen(path, "w");
+    if (!file) return false;
+    fprintf(file, "frame,total_ms");
+    for (int p = 0; p < PROFILE_PHASE_COUNT; p++) {
+        fprintf(file, ",%s_ms", phaseNames[p]);
+    }
+    fprintf(file, ",other_ms,allocations,allocated_bytes,peak_live_bytes\n");
+
+    long first = profiler->frameIndex - profiler->count;
+    for (int age = profiler->count - 1; age >= 0; age--) {
+        const ProfileFrame* frame = profilerFrame(profiler, age);
+        uint64_t phases = 0;
+        fprintf(file, "%ld,%.6f", first + (profiler->count - 1 - age), frame->total / 1e6);
+        for (int p = 0; p < PROFILE_PHASE_COUNT; p++) {
+            fprintf(file, ",%.6f", frame->phase[p] / 1e6);
+            phases += frame->phase[p];
+        }
+        fprintf(file, ",%.6f,%u,%llu,%lld\n", (frame->total > phases ? frame->total - phases : 0) / 1e6,
+                (unsigned)frame->allocations, (unsigned long long)frame->allocatedBytes,
+                (long long)frame->peakLiveBytes);
+    }
+    return fclose(file) == 0;
+}
+
+void profilerPrintCounters(const Profiler* profiler, FILE* out) {
+    const PerfCounters* counters = profiler->counters;
+    if (!counters) return;
+    fprintf(out, "%-12s %10s %14s %14s %6s %12s %8s %12s %8s\n", "phase", "entries", "cycles",
+            "instructions", "IPC", "cache-miss", "per-1k", "branch-miss", "per-1k");
+    for (int p = 0; p < PROFILE_PHASE_COUNT; p++) {
+        if (profiler->phaseEntries[p] == 0) continue;
+        const uint64_t* counts = profiler->phaseCounts[p];
+        double instructions = (double)counts[PERF_INSTRUCTIONS];
+        fprintf(out, "%-12s %10ld %14llu %14llu %6.2f %12llu %8.2f %12llu %8.2f\n",
+                phaseNames[p], profiler->phaseEntries[p],
+                (unsigned long long)counts[PERF_CYCLES], (unsigned long long)counts[PERF_INSTRUCTIONS],
+                counts[PERF_CYCLES] > 0 ? instructions / counts[PERF_CYCLES] : 0.0,
+                (unsigned long long)counts[PERF_CACHE_MISSES],
+                instructions > 0 ? counts[PERF_CACHE_MISSES] * 1000.0 / instructions : 0.0,
+                (unsigned long long)counts[PERF_BRANCH_MISSES],
+                instructions > 0 ? counts[PERF_BRANCH_MISSES] * 1000.0 / instructions : 0.0);
+    }
+    for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+        if (!perfAvailable(counters, c)) {
+            fprintf(out, "(%s not available on this system; shown as 0)\n", perfCounterName(c));
+        }
+    }
+}
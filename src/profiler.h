@@ -0,0 +1,108 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "perf.h"
+
+// Frame-phase profiler. The front end marks each frame and the phases in
+// it; every frame's per-phase times go into a ring of the last N frames,
+// from which the overlay draws its graph and percentiles and the CSV export
+// is written. Phases may nest (collisions run inside update), and each
+// phase is charged only its own time, so the phases of a frame add up to
+// at most the frame time; the rest is "other" (idle, vsync, overlay).
+// Each frame also records the tracked allocations made in it (alloc.h).
+//
+// With hardware counters attached, each phase also gets its cycles,
+// instructions, cache misses and branch misses, split between nested
+// phases the same way as time. These are running totals for the whole run,
+// not per frame, and cost two read() calls per phase.
+//
+// Instrumentation goes to whichever profiler is installed. With none
+// installed every call returns at once, so the simulation can carry its
+// phase markers into headless and batch runs at no real cost.
+
+typedef enum {
+    PROFILE_EVENTS,
+    PROFILE_UPDATE,
+    PROFILE_COLLISIONS,
+    PROFILE_PARTICLES,
+    PROFILE_HUD_TEXT,
+    PROFILE_ENTITIES,
+    PROFILE_PRESENT,
+    PROFILE_PHASE_COUNT
+} ProfilePhase;
+
+#define PROFILE_MAX_DEPTH 8
+
+typedef struct {
+    uint64_t total;                      // nanoseconds, frame begin to end
+    uint64_t phase[PROFILE_PHASE_COUNT]; // nanoseconds, excluding nested phases
+    uint32_t allocations;                // tracked allocations (see alloc.h)
+    uint64_t allocatedBytes;
+    int64_t peakLiveBytes;               // highest tracked live bytes in the frame
+} ProfileFrame;
+
+typedef struct {
+    ProfileFrame* frames; // ring of the last capacity frames
+    int capacity;
+    int count;
+    int next;
+    long frameIndex;      // frames recorded since init
+    double* scratch;      // capacity entries, for sorting percentiles
+    ProfileFrame current;
+    uint64_t frameStart;
+    uint64_t frameAllocations; // allocation totals at frame begin
+    uint64_t frameBytes;
+    bool inFrame;
+    int depth;
+    ProfilePhase stack[PROFILE_MAX_DEPTH];
+    uint64_t started[PROFILE_MAX_DEPTH];
+    uint64_t nested[PROFILE_MAX_DEPTH];  // time spent in child phases
+    PerfCounters* counters;              // NULL when not counting
+    uint64_t startedCounts[PROFILE_MAX_DEPTH][PERF_COUNTER_COUNT];
+    uint64_t nestedCounts[PROFILE_MAX_DEPTH][PERF_COUNTER_COUNT];
+    uint64_t phaseCounts[PROFILE_PHASE_COUNT][PERF_COUNTER_COUNT];
+    long phaseEntries[PROFILE_PHASE_COUNT];
+} Profiler;
+
+// Milliseconds
+typedef struct {
+    double p50;
+    double p95;
+    double p99;
+    double max;
+} ProfilePercentiles;
+
+typedef struct {
+    ProfilePercentiles frame;
+    ProfilePercentiles phase[PROFILE_PHASE_COUNT];
+    int frames; // frames the figures cover
+    uint64_t allocations;  // tracked allocations over those frames
+    int allocatingFrames;  // frames with at least one
+} ProfileSummary;
+
+bool profilerInit(Profiler* profiler, int capacity);
+void profilerFree(Profiler* profiler);
+void profilerInstall(Profiler* profiler); // NULL uninstalls
+// Count per phase from now on; counters must stay open while attached
+void profilerAttachCounters(Profiler* profiler, PerfCounters* counters);
+Profiler* profilerInstalled(void);
+
+uint64_t profilerNow(void); // monotonic nanoseconds
+const char* profilePhaseName(ProfilePhase phase);
+
+void profileFrameBegin(void);
+void profileFrameEnd(void);
+void profileBegin(ProfilePhase phase);
+void profileEnd(ProfilePhase phase);
+
+// Frame age frames ago (0 is the newest); NULL past the recorded history
+const ProfileFrame* profilerFrame(const Profiler* profiler, int age);
+void profilerSummarize(Profiler* profiler, ProfileSummary* summary);
+bool profilerWriteCsv(const Profiler* profiler, const char* path);
+// Per-phase counter totals with IPC and misses per thousand instructions
+void profilerPrintCounters(const Profiler* profiler, FILE* out);
+
+#endif
@@ -0,0 +1,75 @@
+#include "quad_batch.h"
+#include "alloc.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+static bool quadBatchReserve(QuadBatch* batch, int quads) {
+    if (quads <= batch->capacity) return true;
+
+    int capacity = batch->capacity > 0 ? batch->capacity : QUAD_BATCH_INITIAL_QUADS;
+    while (capacity < quads) capacity *= 2;
+
+    SDL_Vertex* vertices = TRACKED_REALLOC(batch->vertices, (size_t)capacity * 4 * sizeof(SDL_Vertex));
+    if (!vertices) return false;
+    batch->vertices = vertices;
+    int* indices = TRACKED_REALLOC(batch->indices, (size_t)capacity * 6 * sizeof(int));
+    if (!indices) return false;
+    batch->indices = indices;
+
+    // Two triangles per quad; the pattern only depends on the quad number
+    for (int q = batch->capacity; q < capacity; q++) {
+        int* index = &indices[q * 6];
+        int base = q * 4;
+        index[0] = base; index[1] = base + 1; index[2] = base + 2;
+        index[3] = base + 2; index[4] = base + 3; index[5] = base;
+    }
+    batch->capacity = capacity;
+    return true;
+}
+
+bool quadBatchInit(QuadBatch* batch) {
+    batch->vertices = NULL;
+    batch->indices = NULL;
+    batch->quadCount = 0;
+    batch->capacity = 0;
+    if (!quadBatchReserve(batch, QUAD_BATCH_INITIAL_QUADS)) {
+        printf("Could not allocate quad batch\n");
+        return false;
+    }
+    return true;
+}
+
+void quadBatchFree(QuadBatch* batch) {
+    TRACKED_FREE(batch->vertices);
+    TRACKED_FREE(batch->indices);
+    batch->vertices = NULL;
+    batch->indices = NULL;
+    batch->quadCount = 0;
+    batch->capacity = 0;
+}
+
+void quadBatchAddTextured(QuadBatch* batch, float x, float y, float w, float h,
+                          float u0, float v0, float u1, float v1, Color color) {
+    if (!quadBatchReserve(batch, batch->quadCount + 1)) return;
+
+    SDL_Color c = {color.r, color.g, color.b, color.a};
+    SDL_Vertex* v = &batch->vertices[batch->quadCount * 4];
+    v[0] = (SDL_Vertex){{x, y}, c, {u0, v0}};
+    v[1] = (SDL_Vertex){{x + w, y}, c, {u1, v0}};
+    v[2] = (SDL_Vertex){{x + w, y + h}, c, {u1, v1}};
+    v[3] = (SDL_Vertex){{x, y + h}, c, {u0, v1}};
+    batch->quadCount++;
+}
+
+void quadBatchAddRect(QuadBatch* batch, float x, float y, float w, float h, Color color) {
+    quadBatchAddTextured(batch, x, y, w, h, 0.0f, 0.0f, 0.0f, 0.0f, color);
+}
+
+// Draw everything queued in one call and start a new batch
+void quadBatchFlush(QuadBatch* batch, SDL_Renderer* renderer, SDL_Texture* texture) {
+    if (batch->quadCount > 0) {
+        SDL_RenderGeometry(renderer, texture, batch->vertices, batch->quadCount * 4,
+                           batch->indices, batch->quadCount * 6);
+    }
+    batch->quadCount = 0;
+}
@@ -0,0 +1,28 @@
+#ifndef QUAD_BATCH_H
+#define QUAD_BATCH_H
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+#include "sim.h"
+
+// Collects colored (optionally textured) quads and submits them with a
+// single SDL_RenderGeometry call. Buffers grow as needed and are kept
+// between frames, so steady-state drawing does not allocate.
+
+#define QUAD_BATCH_INITIAL_QUADS 256
+
+typedef struct {
+    SDL_Vertex* vertices;
+    int* indices;
+    int quadCount;
+    int capacity; // in quads
+} QuadBatch;
+
+bool quadBatchInit(QuadBatch* batch);
+void quadBatchFree(QuadBatch* batch);
+void quadBatchAddRect(QuadBatch* batch, float x, float y, float w, float h, Color color);
+void quadBatchAddTextured(QuadBatch* batch, float x, float y, float w, float h,
+                          float u0, float v0, float u1, float v1, Color color);
+void quadBatchFlush(QuadBatch* batch, SDL_Renderer* renderer, SDL_Texture* texture);
+
+#endif
@@ -0,0 +1,87 @@
+#include "radix.h"
+#include "radix_tables.h"
+#include <stdio.h>
+
+int radixDigitValue(char c, int radix) {
+    int value = RADIX_DIGIT_VALUE[(unsigned char)c];
+    return value < radix ? value : -1;
+}
+
+int radixDigitBits(int radix) {
+    return radix >= RADIX_MIN && radix <= RADIX_MAX ? RADIX_DIGIT_BITS[radix] : 0;
+}
+
+int radixChunkDigits(int radix) {
+    return radix >= RADIX_MIN && radix <= RADIX_MAX ? RADIX_CHUNK_DIGITS[radix] : 0;
+}
+
+uint64_t radixChunkBase(int radix) {
+    return radix >= RADIX_MIN && radix <= RADIX_MAX ? RADIX_CHUNK_BASE[radix] : 0;
+}
+
+int levelBitsLookup(int number, ConversionType type, BitVector* out) {
+    if (number < 0 || number > LEVEL_TABLE_MAX || type < CONVERSION_DECIMAL || type > CONVERSION_HEXADECIMAL) {
+        return convertToBinary(number, out, type);
+    }
+    bitvecClear(out);
+    out->words[0] = LEVEL_BITS_VALUE[type][number];
+    out->length = LEVEL_BITS_LENGTH[type][number];
+    return out->length;
+}
+
+// Valid octal spellings are the octal numerals of 0, 1, 2, ... read as
+// decimal, so the count of those <= n is one more than the octal value of
+// the largest one <= n (n's digits with the first 8 or 9 and everything
+// after it turned into 7s)
+static long long octalSpellingsUpTo(int n) {
+    if (n < 0) return 0;
+    char digits[16];
+    int length = snprintf(digits, sizeof(digits), "%d", n);
+    long long value = 0;
+    bool capped = false;
+    for (int i = 0; i < length; i++) {
+        int digit = digits[i] - '0';
+        if (capped || digit > 7) {
+            capped = true;
+            digit = 7;
+        }
+        value = value * 8 + digit;
+    }
+    return value + 1;
+}
+
+// The index-th valid octal spelling: index in octal, read as decimal
+static int octalSpelling(long long index) {
+    long long spelled = 0;
+    long long place = 1;
+    do {
+        spelled += (index % 8) * place;
+        place *= 10;
+        index /= 8;
+    } while (index > 0);
+    return (int)spelled;
+}
+
+// Above the tables (data-driven ranges past LEVEL_TABLE_MAX) the same
+// uniform pick is computed at run time
+static int levelPickOctalWide(int minNumber, int maxNumber, int draw) {
+    long long below = octalSpellingsUpTo(minNumber - 1);
+    long long available = octalSpellingsUpTo(maxNumber) - below;
+    if (available <= 0) {
+        return LEVEL_OCTAL_VALID[0];
+    }
+    return octalSpelling(below + draw % available);
+}
+
+int levelPickOctal(int minNumber, int maxNumber, int draw) {
+    if (minNumber < 0) minNumber = 0;
+    if (maxNumber > LEVEL_TABLE_MAX) {
+        return levelPickOctalWide(minNumber, maxNumber, draw);
+    }
+    int below = minNumber > 0 ? LEVEL_OCTAL_RANK[minNumber - 1] : 0;
+    int available = LEVEL_OCTAL_RANK[maxNumber] - below;
+    if (available <= 0) {
+        return LEVEL_OCTAL_VALID[0];
+    }
+    return LEVEL_OCTAL_VALID[below + draw % available];
+}
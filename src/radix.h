@@ -0,0 +1,34 @@
+#ifndef RADIX_H
+#define RADIX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "binary.h"
+
+// Table-driven digit decoding and level conversions. The lookup tables
+// live in radix_tables.h, which the Makefile generates at build time;
+// bignum.c does the digit-string parsing on top of these.
+
+// Value of digit c in radix (2 to 36), or -1 if c is not a digit of it
+int radixDigitValue(char c, int radix);
+
+// Bits per digit for power-of-two radices, 0 for the others
+int radixDigitBits(int radix);
+
+// The most digits that fit one 64-bit limb, and radix raised to that count
+// (0 outside 2 to 36); the chunk size for multiply-add parsing
+int radixChunkDigits(int radix);
+uint64_t radixChunkBase(int radix);
+
+// Level numbers (0..LEVEL_TABLE_MAX) come from precomputed conversions;
+// anything outside that range falls back to convertToBinary
+int levelBitsLookup(int number, ConversionType type, BitVector* out);
+
+// Maps a random draw onto the valid octal spellings in [minNumber, maxNumber]
+// (uniformly, like rejection sampling) without testing digits one by one.
+// Within the level tables the pick tops out at 777, as the game always has;
+// wider ranges are handled at run time up to maxNumber itself
+int levelPickOctal(int minNumber, int maxNumber, int draw);
+
+#endif
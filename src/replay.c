@@ -0,0 +1,179 @@
+#include "replay.h"
+#include "alloc.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define REPLAY_INPUT_BITS 3
+#define REPLAY_END_CODE 7 // input code reserved for the end marker
+
+static const char replayMagic[4] = {'B', 'Q', 'R', 'P'};
+
+static void writeVarint(FILE* file, uint64_t value) {
+    while (value >= 0x80) {
+        fputc((int)(value & 0x7F) | 0x80, file);
+        value >>= 7;
+    }
+    fputc((int)value, file);
+}
+
+static bool readVarint(FILE* file, uint64_t* value) {
+    uint64_t result = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int byte = fgetc(file);
+        if (byte == EOF) return false;
+        result |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+static uint32_t floatBits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static float bitsToFloat(uint32_t bits) {
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static bool replayPush(Replay* replay, uint32_t tick, uint8_t input) {
+    if (replay->count == replay->capacity) {
+        int capacity = replay->capacity > 0 ? replay->capacity * 2 : REPLAY_INITIAL_EVENTS;
+        ReplayEvent* events = TRACKED_REALLOC(replay->events, (size_t)capacity * sizeof(ReplayEvent));
+        if (!events) return false;
+        replay->events = events;
+        replay->capacity = capacity;
+    }
+    replay->events[replay->count++] = (ReplayEvent){tick, input};
+    return true;
+}
+
+void replayBegin(Replay* replay, const GameState* game, float tickSeconds) {
+    replay->seed = game->seed;
+    replay->conversionType = game->conversionType;
+    memcpy(replay->digits, game->numberDigits, sizeof(replay->digits));
+    replay->tickSeconds = tickSeconds;
+    replay->stormBitsPerTick = game->stormBitsPerTick;
+    replay->particleScale = game->particleScale;
+    replay->count = 0;
+    replay->endTick = game->tick;
+    replay->cursor = 0;
+    replay->recording = true;
+}
+
+// Stamped with the number of ticks already run, i.e. it applies before the next one
+bool replayRecord(Replay* replay, const GameState* game, SimInput input) {
+    if (!replay->recording) return true;
+    return replayPush(replay, game->tick, (uint8_t)input);
+}
+
+void replayFinish(Replay* replay, const GameState* game) {
+    if (!replay->recording) return;
+    replay->endTick = game->tick;
+    replay->recording = false;
+}
+
+bool replaySave(const Replay* replay, const char* path) {
+    FILE* file = fopen(path, "wb");
+    if (!file) return false;
+
+    fwrite(replayMagic, 1, sizeof(replayMagic), file);
+    fputc(REPLAY_VERSION, file);
+    writeVarint(file, replay->seed);
+    writeVarint(file, (uint64_t)replay->conversionType);
+    writeVarint(file, floatBits(replay->tickSeconds));
+    writeVarint(file, (uint64_t)replay->stormBitsPerTick);
+    writeVarint(file, (uint64_t)replay->particleScale);
+    size_t digitCount = strlen(replay->digits);
+    writeVarint(file, digitCount);
+    fwrite(replay->digits, 1, digitCount, file);
+
+    uint32_t tick = 0;
+    for (int i = 0; i < replay->count; i++) {
+        const ReplayEvent* event = &replay->events[i];
+        writeVarint(file, ((uint64_t)(event->tick - tick) << REPLAY_INPUT_BITS) | event->input);
+        tick = event->tick;
+    }
+    uint32_t endTick = replay->endTick > tick ? replay->endTick : tick;
+    writeVarint(file, ((uint64_t)(endTick - tick) << REPLAY_INPUT_BITS) | REPLAY_END_CODE);
+
+    bool ok = !ferror(file);
+    if (fclose(file) != 0) ok = false;
+    return ok;
+}
+
+bool replayLoad(Replay* replay, const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+
+    char magic[sizeof(replayMagic)];
+    uint64_t seed, type, tickBits, storm, scale, digitCount;
+    bool ok = fread(magic, 1, sizeof(magic), file) == sizeof(magic) &&
+              memcmp(magic, replayMagic, sizeof(magic)) == 0 &&
+              fgetc(file) == REPLAY_VERSION &&
+              readVarint(file, &seed) && readVarint(file, &type) &&
+              readVarint(file, &tickBits) && readVarint(file, &storm) &&
+              readVarint(file, &scale) && readVarint(file, &digitCount) &&
+              type <= CONVERSION_HEXADECIMAL && digitCount <= MAX_NUMBER_DIGITS &&
+              fread(replay->digits, 1, (size_t)digitCount, file) == digitCount;
+    if (ok) {
+        replay->digits[digitCount] = '\0';
+        replay->seed = seed;
+        replay->conversionType = (ConversionType)type;
+        replay->tickSeconds = bitsToFloat((uint32_t)tickBits);
+        replay->stormBitsPerTick = (int)storm;
+        replay->particleScale = (int)scale;
+        replay->count = 0;
+        replay->cursor = 0;
+        replay->recording = false;
+    }
+
+    uint32_t tick = 0;
+    while (ok) {
+        uint64_t packed;
+        ok = readVarint(file, &packed);
+        if (!ok) break;
+        tick += (uint32_t)(packed >> REPLAY_INPUT_BITS);
+        uint8_t code = (uint8_t)(packed & ((1u << REPLAY_INPUT_BITS) - 1));
+        if (code == REPLAY_END_CODE) {
+            replay->endTick = tick;
+            break;
+        }
+        ok = code < SIM_INPUT_COUNT && replayPush(replay, tick, code);
+    }
+    fclose(file);
+    return ok;
+}
+
+// Set the game up exactly as it was when recording began
+bool replayStart(Replay* replay, GameState* game) {
+    simSetSeed(game, replay->seed);
+    if (!initGameFromDigits(game, replay->digits, replay->conversionType)) return false;
+    simSetBitStorm(game, replay->stormBitsPerTick);
+    simSetParticleScale(game, replay->particleScale);
+    replay->cursor = 0;
+    return true;
+}
+
+void replayApply(Replay* replay, GameState* game) {
+    while (replay->cursor < replay->count && replay->events[replay->cursor].tick <= game->tick) {
+        simApplyInput(game, (SimInput)replay->events[replay->cursor].input);
+        replay->cursor++;
+    }
+}
+
+bool replayDone(const Replay* replay, const GameState* game) {
+    return game->gameOver || (replay->cursor >= replay->count && game->tick >= replay->endTick);
+}
+
+void replayFree(Replay* replay) {
+    TRACKED_FREE(replay->events);
+    *replay = (Replay){0};
+}
@@ -0,0 +1,55 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sim.h"
+
+// Input-log replays: the game setup (seed, number, tick length, stress
+// options) plus every SimInput stamped with the tick it was applied before.
+// Since the simulation is deterministic for a seed, replaying the log
+// reproduces the session exactly, at real time or as fast as possible.
+//
+// File layout: "BQRP", a version byte, then LEB128 varints for the header
+// fields and one varint per event holding (tick delta << 3) | input. An
+// end marker carries the delta to the last tick of the session.
+
+#define REPLAY_VERSION 1
+#define REPLAY_INITIAL_EVENTS 256
+
+typedef struct {
+    uint32_t tick;
+    uint8_t input; // SimInput
+} ReplayEvent;
+
+typedef struct {
+    uint64_t seed;
+    ConversionType conversionType;
+    char digits[MAX_NUMBER_DIGITS + 1];
+    float tickSeconds;
+    int stormBitsPerTick;
+    int particleScale;
+
+    ReplayEvent* events;
+    int count;
+    int capacity;
+    uint32_t endTick;
+    int cursor;     // next event to play back
+    bool recording;
+} Replay;
+
+// Recording: call replayBegin right after the game is initialized
+void replayBegin(Replay* replay, const GameState* game, float tickSeconds);
+bool replayRecord(Replay* replay, const GameState* game, SimInput input);
+void replayFinish(Replay* replay, const GameState* game);
+bool replaySave(const Replay* replay, const char* path);
+
+// Playback: replayApply before every updateGame until replayDone
+bool replayLoad(Replay* replay, const char* path);
+bool replayStart(Replay* replay, GameState* game);
+void replayApply(Replay* replay, GameState* game);
+bool replayDone(const Replay* replay, const GameState* game);
+
+void replayFree(Replay* replay);
+
+#endif
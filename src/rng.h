@@ -0,0 +1,59 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+// PCG32 (O'Neill, XSH-RR variant): 64-bit state, 32-bit output. Each
+// stream constant selects an independent sequence for the same seed, so
+// gameplay systems can draw numbers without disturbing each other.
+
+typedef struct {
+    uint64_t state;
+    uint64_t increment; // odd; selects the stream
+} Rng;
+
+static inline uint32_t rngNext(Rng* rng) {
+    uint64_t old = rng->state;
+    rng->state = old * 6364136223846793005ull + rng->increment;
+    uint32_t xorShifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+    uint32_t rotation = (uint32_t)(old >> 59);
+    return (xorShifted >> rotation) | (xorShifted << ((-rotation) & 31));
+}
+
+static inline void rngSeed(Rng* rng, uint64_t seed, uint64_t stream) {
+    rng->state = 0;
+    rng->increment = (stream << 1) | 1;
+    rngNext(rng);
+    rng->state += seed;
+    rngNext(rng);
+}
+
+// Uniform in [0, bound) without modulo bias (Lemire's multiply-and-reject)
+static inline uint32_t rngBelow(Rng* rng, uint32_t bound) {
+    uint64_t product = (uint64_t)rngNext(rng) * bound;
+    uint32_t low = (uint32_t)product;
+    if (low < bound) {
+        uint32_t threshold = (0u - bound) % bound;
+        while (low < threshold) {
+            product = (uint64_t)rngNext(rng) * bound;
+            low = (uint32_t)product;
+        }
+    }
+    return (uint32_t)(product >> 32);
+}
+
+// Uniform integer in [min, max]
+static inline int rngRange(Rng* rng, int min, int max) {
+    return min + (int)rngBelow(rng, (uint32_t)(max - min + 1));
+}
+
+// Stateless mix (splitmix64 finalizer) for values that must not consume a
+// stream, e.g. effects computed by the renderer
+static inline uint64_t rngHash64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+#endif
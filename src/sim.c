@@ -0,0 +1,663 @@
+#include "sim.h"
+#include "bignum.h"
+#include "radix.h"
+#include "profiler.h"
+#include "trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Color definitions
+const Color COLOR_WHITE = {255, 255, 255, 255};
+const Color COLOR_BLACK = {0, 0, 0, 255};
+const Color COLOR_RED = {255, 0, 0, 255};
+const Color COLOR_GREEN = {0, 255, 0, 255};
+const Color COLOR_BLUE = {0, 0, 255, 255};
+const Color COLOR_YELLOW = {255, 255, 0, 255};
+const Color COLOR_CYAN = {0, 255, 255, 255};
+const Color COLOR_MAGENTA = {255, 0, 255, 255};
+const Color COLOR_ORANGE = {255, 165, 0, 255};
+const Color COLOR_PURPLE = {128, 0, 128, 255};
+
+// Hex values are stored as integers, octal ones as their decimal-digit spelling
+static void formatNumberDigits(GameState* game) {
+    const char* format = game->conversionType == CONVERSION_HEXADECIMAL ? "%X" : "%d";
+    snprintf(game->numberDigits, sizeof(game->numberDigits), format, game->originalNumber);
+}
+
+bool initGame(GameState* game, int number, ConversionType conversionType) {
+    TRACE_FUNCTION();
+    rngSeed(&game->spawnRng, game->seed, SIM_STREAM_SPAWN);
+    rngSeed(&game->levelRng, game->seed, SIM_STREAM_LEVEL);
+    rngSeed(&game->powerUpRng, game->seed, SIM_STREAM_POWERUP);
+    rngSeed(&game->cosmeticRng, game->seed, SIM_STREAM_COSMETIC);
+    game->tick = 0;
+    if (!game->customDifficulty) {
+        game->difficulty = simDefaultDifficulty();
+    }
+    
+    game->originalNumber = number;
+    game->conversionType = conversionType;
+    formatNumberDigits(game);
+    
+    levelBitsLookup(number, conversionType, &game->bits);
+    bitvecClear(&game->collectedBits);
+    game->currentBitIndex = 0;
+    game->expectedBitIndex = 0;
+    game->score = 0;
+    game->level = 1;
+    game->gameOver = false;
+    game->paused = false;
+    game->gameSpeed = 1.0f;
+    game->nextBitTimer = 0;
+    game->powerUpSpawnTimer = 0;
+    game->showBinaryResult = false;
+    game->levelComplete = false;
+    game->wrongBitPenalty = 0;
+    game->continuousFallTimer = 0;
+    game->screenShakeTimer = 0;
+    game->screenShakeIntensity = 0.0f;
+    game->transitionTimer = 0;
+    game->isTransitioning = false;
+    game->nextLevelNumber = 0;
+    game->wrongBitCount = 0; // Initialize wrong bit counter
+    game->minNumber = 1;
+    game->maxNumber = game->difficulty.startMax; // Start with smaller numbers
+
+    game->eventCount = 0;
+    game->moveLeft = false;
+    game->moveRight = false;
+
+    // Initialize player
+    game->player.x = GAME_AREA_X + GAME_AREA_WIDTH / 2 - PLAYER_WIDTH / 2;
+    game->player.prevX = game->player.x;
+    game->player.width = PLAYER_WIDTH;
+    game->player.speed = 300.0f;
+    game->player.lives = 3;
+    game->player.hasSpeedBoost = false;
+    game->player.hasScoreMultiplier = false;
+    game->player.hasSlowTime = false;
+    for (int i = 0; i < 3; i++) {
+        game->player.powerUpTimer[i] = 0.0f;
+    }
+
+    // Empty the pools but keep their storage from any previous game. Room
+    // for the usual working set is reserved here, so normal play never
+    // allocates; only storms and stress runs grow the pools past it
+    int particleRoom = POOL_INITIAL_CAPACITY * (game->particleScale > 1 ? game->particleScale : 1);
+    particlePoolResize(&game->particles, particleRoom);
+    bitPoolResize(&game->fallingBits, POOL_INITIAL_CAPACITY);
+    powerUpPoolResize(&game->powerUps, POOL_INITIAL_CAPACITY);
+    broadphaseReserve(&game->bitGrid, POOL_INITIAL_CAPACITY);
+    broadphaseReserve(&game->powerUpGrid, POOL_INITIAL_CAPACITY);
+    game->particles.count = 0;
+    game->fallingBits.count = 0;
+    game->powerUps.count = 0;
+
+    return true;
+}
+
+// Start a game from a typed digit string of any width up to MAX_BITS
+bool initGameFromDigits(GameState* game, const char* digits, ConversionType conversionType) {
+    BitVector value;
+    if (!convertDigitsToBinary(digits, conversionType, &value)) {
+        return false;
+    }
+    if (!initGame(game, 0, conversionType)) {
+        return false;
+    }
+    game->bits = value;
+    snprintf(game->numberDigits, sizeof(game->numberDigits), "%s", digits);
+    return true;
+}
+
+void spawnBit(GameState* game) {
+    // Outside bit storm mode only a few bits are on screen at once
+    if (game->stormBitsPerTick == 0 && game->fallingBits.count >= MAX_FALLING_BITS) {
+        return;
+    }
+    BitPool* bits = &game->fallingBits;
+    int i = bitPoolAdd(bits);
+    if (i < 0) return;
+
+    bits->x[i] = GAME_AREA_X + rngBelow(&game->spawnRng, GAME_AREA_WIDTH - BIT_SIZE);
+    bits->y[i] = GAME_AREA_Y;
+    bits->prevX[i] = bits->x[i];
+    bits->prevY[i] = bits->y[i];
+
+    // Spawn random bits from the binary representation
+    int randomBitIndex = rngBelow(&game->spawnRng, game->bits.length);
+    bits->value[i] = (uint8_t)bitvecGet(&game->bits, randomBitIndex);
+    bits->speed[i] = game->difficulty.fallSpeed + game->level * game->difficulty.fallSpeedStep;
+}
+
+void spawnPowerUp(GameState* game) {
+    if (game->powerUps.count >= MAX_POWERUPS) {
+        return;
+    }
+    PowerUpPool* powerUps = &game->powerUps;
+    int i = powerUpPoolAdd(powerUps);
+    if (i < 0) return;
+
+    powerUps->x[i] = GAME_AREA_X + rngBelow(&game->powerUpRng, GAME_AREA_WIDTH - POWERUP_SIZE);
+    powerUps->y[i] = GAME_AREA_Y;
+    powerUps->prevX[i] = powerUps->x[i];
+    powerUps->prevY[i] = powerUps->y[i];
+    powerUps->type[i] = (uint8_t)rngBelow(&game->powerUpRng, 3);
+    powerUps->speed[i] = 80.0f;
+    powerUps->duration[i] = POWERUP_DURATION;
+}
+
+bool isCorrectBit(const GameState* game, int bitValue) {
+    if (game->collectedBits.length >= game->bits.length) {
+        return false; // All bits already collected
+    }
+    // Correct if the collected bits plus this one are still a prefix of the answer
+    BitVector candidate = game->collectedBits;
+    bitvecAppend(&candidate, bitValue);
+    return bitvecIsPrefix(&candidate, &game->bits);
+}
+
+void generateNewLevel(GameState* game) {
+    game->level++;
+
+    // Increase difficulty by expanding number range
+    const Difficulty* difficulty = &game->difficulty;
+    int range = 0;
+    while (range < DIFFICULTY_RANGES - 1 && game->level > difficulty->rangeLevels[range]) {
+        range++;
+    }
+    game->maxNumber = difficulty->rangeMax[range];
+
+    // Generate random number for new level
+    int newNumber;
+    
+    if (game->conversionType == CONVERSION_OCTAL) {
+        // For octal, pick among the valid octal spellings (no digits 8 or 9)
+        newNumber = levelPickOctal(game->minNumber, game->maxNumber, (int)(rngNext(&game->levelRng) >> 1));
+    } else {
+        newNumber = rngRange(&game->levelRng, game->minNumber, game->maxNumber);
+    }
+
+    // Reset level immediately instead of using transition
+    resetLevel(game, newNumber);
+}
+
+void resetLevel(GameState* game, int newNumber) {
+    game->originalNumber = newNumber;
+    formatNumberDigits(game);
+    
+    levelBitsLookup(newNumber, game->conversionType, &game->bits);
+    game->currentBitIndex = 0;
+    game->expectedBitIndex = 0;
+    game->levelComplete = false;
+    game->showBinaryResult = false;
+    game->continuousFallTimer = 0;
+    game->isTransitioning = false;
+    
+    // Clear collected bits
+    bitvecClear(&game->collectedBits);
+    
+    // Clear all falling bits
+    game->fallingBits.count = 0;
+    
+    // Increase game speed slightly
+    game->gameSpeed = 1.0f + (game->level - 1) * game->difficulty.gameSpeedStep;
+}
+
+// A falling bit touched the player
+static void collectBit(GameState* game, int i) {
+    BitPool* bits = &game->fallingBits;
+
+    // Check if this is the correct bit in sequence
+    if (isCorrectBit(game, bits->value[i])) {
+        // Correct bit collected
+        bitvecAppend(&game->collectedBits, bits->value[i]);
+        game->expectedBitIndex++;
+        
+        int points = 10;
+        if (game->player.hasScoreMultiplier) points *= 2;
+        game->score += points;
+        
+        // Spawn particles for correct bit collection
+        spawnParticles(game, bits->x[i] + BIT_SIZE/2,
+                     bits->y[i] + BIT_SIZE/2,
+                     PARTICLE_BIT_COLLECT, 8);
+        
+        simPushEvent(game, SIM_EVENT_BIT_COLLECT);
+        
+        // Check if level is complete
+        if (bitvecEqual(&game->collectedBits, &game->bits)) {
+            game->levelComplete = true;
+            game->score += 50 * game->level; // Bonus for completing level
+            spawnParticles(game, bits->x[i] + BIT_SIZE/2,
+                         bits->y[i] + BIT_SIZE/2,
+                         PARTICLE_LEVEL_COMPLETE, 15);
+            
+            simPushEvent(game, SIM_EVENT_LEVEL_COMPLETE);
+        }
+    } else {
+        // Wrong bit collected - penalty
+        game->wrongBitCount++;
+        game->wrongBitPenalty = WRONG_BIT_PENALTY_DURATION; // Show penalty indicator
+        
+        // Trigger screen shake for wrong bit
+        triggerScreenShake(game, 5.0f);
+        
+        // Spawn particles for wrong bit
+        spawnParticles(game, bits->x[i] + BIT_SIZE/2,
+                     bits->y[i] + BIT_SIZE/2,
+                     PARTICLE_WRONG_BIT, 12);
+        
+        simPushEvent(game, SIM_EVENT_WRONG_BIT);
+        
+        // End game after 3 wrong bits
+        if (game->wrongBitCount >= 3) {
+            game->gameOver = true;
+            // Stop screen shake immediately when game ends
+            game->screenShakeTimer = 0;
+            game->screenShakeIntensity = 0.0f;
+            simPushEvent(game, SIM_EVENT_GAME_OVER);
+        }
+    }
+}
+
+// A power-up touched the player
+static void collectPowerUp(GameState* game, int i) {
+    PowerUpPool* powerUps = &game->powerUps;
+
+    // Activate power-up
+    switch (powerUps->type[i]) {
+        case 0: // Speed boost
+            game->player.hasSpeedBoost = true;
+            game->player.powerUpTimer[0] = powerUps->duration[i];
+            spawnParticles(game, powerUps->x[i] + POWERUP_SIZE/2,
+                         powerUps->y[i] + POWERUP_SIZE/2,
+                         PARTICLE_POWERUP, 10);
+            break;
+        case 1: // Score multiplier
+            game->player.hasScoreMultiplier = true;
+            game->player.powerUpTimer[1] = powerUps->duration[i];
+            spawnParticles(game, powerUps->x[i] + POWERUP_SIZE/2,
+                         powerUps->y[i] + POWERUP_SIZE/2,
+                         PARTICLE_POWERUP, 10);
+            break;
+        case 2: // Slow time
+            game->player.hasSlowTime = true;
+            game->player.powerUpTimer[2] = powerUps->duration[i];
+            game->gameSpeed = 0.5f;
+            spawnParticles(game, powerUps->x[i] + POWERUP_SIZE/2,
+                         powerUps->y[i] + POWERUP_SIZE/2,
+                         PARTICLE_POWERUP, 10);
+            break;
+    }
+    simPushEvent(game, SIM_EVENT_POWERUP);
+    game->score += 5;
+}
+
+static int compareDescending(const void* a, const void* b) {
+    return *(const int*)b - *(const int*)a;
+}
+
+// Time of first overlap, along one axis, of a box [a, a + aSize) moving by
+// delta against a fixed box [b, b + bSize); false if they never overlap
+static bool sweepAxis(float a, float aSize, float delta, float b, float bSize,
+                      float* enter, float* exit) {
+    if (delta == 0.0f) {
+        *enter = -1.0f;
+        *exit = 2.0f;
+        return a + aSize > b && a < b + bSize;
+    }
+    float t1 = (b - (a + aSize)) / delta;
+    float t2 = (b + bSize - a) / delta;
+    *enter = t1 < t2 ? t1 : t2;
+    *exit = t1 < t2 ? t2 : t1;
+    return true;
+}
+
+// Swept AABB: does a box moving from (x0, y0) by (dx, dy) touch the fixed
+// box at any point during the step? Callers pass motion relative to the player.
+static bool sweptOverlap(float x0, float y0, float size, float dx, float dy,
+                         float left, float top, float width, float height) {
+    float enterX, exitX, enterY, exitY;
+    if (!sweepAxis(x0, size, dx, left, width, &enterX, &exitX) ||
+        !sweepAxis(y0, size, dy, top, height, &enterY, &exitY)) {
+        return false;
+    }
+    float enter = enterX > enterY ? enterX : enterY;
+    float exit = exitX < exitY ? exitX : exitY;
+    return enter < exit && enter < 1.0f && exit > 0.0f;
+}
+
+#define CONTACT_HIT -2 // Broadphase.column mark for entities that hit the player
+
+typedef struct {
+    const float* x;
+    const float* y;
+    const float* prevX;
+    const float* prevY;
+    float size;
+} SweptBoxes;
+
+// Narrow phase over the expired entities and the grid columns the player
+// covered this tick. Hits are swept from the previous tick's positions,
+// so fast entities or long ticks can't step through the player. Returns
+// the expired entities plus the hits (marked CONTACT_HIT in grid->column),
+// highest index first so they can be swap-removed in order.
+static int gatherContacts(Broadphase* grid, SweptBoxes boxes, const Player* player,
+                          float top, float bottom) {
+    float playerDx = player->x - player->prevX;
+    float sweepLeft = playerDx < 0 ? player->x : player->prevX;
+    float sweepRight = (playerDx < 0 ? player->prevX : player->x) + player->width;
+
+    int* contacts = grid->expired; // has room for every entity
+    int count = grid->expiredCount;
+    for (int k = 0; k < count; k++) {
+        int i = contacts[k];
+        if (sweptOverlap(boxes.prevX[i], boxes.prevY[i], boxes.size,
+                         boxes.x[i] - boxes.prevX[i] - playerDx, boxes.y[i] - boxes.prevY[i],
+                         player->prevX, top, player->width, bottom - top)) {
+            grid->column[i] = CONTACT_HIT;
+        }
+    }
+
+    int first, last;
+    broadphaseColumns(sweepLeft, sweepRight, boxes.size, &first, &last);
+    for (int k = grid->columnStart[first]; k < grid->columnStart[last + 1]; k++) {
+        int i = grid->items[k];
+        if (sweptOverlap(boxes.prevX[i], boxes.prevY[i], boxes.size,
+                         boxes.x[i] - boxes.prevX[i] - playerDx, boxes.y[i] - boxes.prevY[i],
+                         player->prevX, top, player->width, bottom - top)) {
+            grid->column[i] = CONTACT_HIT;
+            contacts[count++] = i;
+        }
+    }
+    qsort(contacts, count, sizeof(int), compareDescending);
+    return count;
+}
+
+void checkCollisions(GameState* game) {
+    TRACE_FUNCTION();
+    float playerTop = GAME_AREA_Y + GAME_AREA_HEIGHT - PLAYER_HEIGHT;
+    float playerBottom = GAME_AREA_Y + GAME_AREA_HEIGHT;
+
+    // Bits: anything past the bottom that didn't hit is just removed, no
+    // penalty for misses
+    BitPool* bits = &game->fallingBits;
+    Broadphase* bitGrid = &game->bitGrid;
+    if (broadphaseBuild(bitGrid, bits->x, bits->y, bits->count, BIT_SIZE, playerTop, playerBottom)) {
+        SweptBoxes boxes = {bits->x, bits->y, bits->prevX, bits->prevY, BIT_SIZE};
+        int count = gatherContacts(bitGrid, boxes, &game->player, playerTop, playerBottom);
+        for (int k = 0; k < count; k++) {
+            int i = bitGrid->expired[k];
+            if (bitGrid->column[i] == CONTACT_HIT) {
+                collectBit(game, i);
+            }
+            bitPoolRemove(bits, i);
+        }
+    }
+
+    // Power-ups
+    PowerUpPool* powerUps = &game->powerUps;
+    Broadphase* powerUpGrid = &game->powerUpGrid;
+    if (broadphaseBuild(powerUpGrid, powerUps->x, powerUps->y, powerUps->count, POWERUP_SIZE,
+                        playerTop, playerBottom)) {
+        SweptBoxes boxes = {powerUps->x, powerUps->y, powerUps->prevX, powerUps->prevY, POWERUP_SIZE};
+        int count = gatherContacts(powerUpGrid, boxes, &game->player, playerTop, playerBottom);
+        for (int k = 0; k < count; k++) {
+            int i = powerUpGrid->expired[k];
+            if (powerUpGrid->column[i] == CONTACT_HIT) {
+                collectPowerUp(game, i);
+            }
+            powerUpPoolRemove(powerUps, i);
+        }
+    }
+}
+
+void updatePowerUps(GameState* game, float deltaTime) {
+    for (int i = 0; i < 3; i++) {
+        if (game->player.powerUpTimer[i] > 0) {
+            game->player.powerUpTimer[i] -= deltaTime;
+            if (game->player.powerUpTimer[i] <= 0) {
+                switch (i) {
+                    case 0:
+                        game->player.hasSpeedBoost = false;
+                        break;
+                    case 1:
+                        game->player.hasScoreMultiplier = false;
+                        break;
+                    case 2:
+                        game->player.hasSlowTime = false;
+                        game->gameSpeed = 1.0f;
+                        break;
+                }
+            }
+        }
+    }
+}
+
+void updateGame(GameState* game, float deltaTime) {
+    TRACE_FUNCTION();
+    if (game->gameOver || game->paused) return;
+    game->tick++;
+
+    // Remember where everything was so the renderer can interpolate
+    BitPool* bits = &game->fallingBits;
+    PowerUpPool* powerUps = &game->powerUps;
+    game->player.prevX = game->player.x;
+    for (int i = 0; i < bits->count; i++) {
+        bits->prevX[i] = bits->x[i];
+        bits->prevY[i] = bits->y[i];
+    }
+    for (int i = 0; i < powerUps->count; i++) {
+        powerUps->prevX[i] = powerUps->x[i];
+        powerUps->prevY[i] = powerUps->y[i];
+    }
+
+    // Player movement and effect timers run in real time, not slowed time
+    float realDelta = deltaTime;
+    if (game->moveLeft != game->moveRight) {
+        simMovePlayer(game, game->moveLeft ? -1 : 1, realDelta);
+    }
+
+    deltaTime *= game->gameSpeed;
+
+    // Update power-ups
+    updatePowerUps(game, realDelta);
+    
+    // Update penalty indicator
+    if (game->wrongBitPenalty > 0) {
+        game->wrongBitPenalty -= realDelta;
+    }
+
+    // Update particles
+    profileBegin(PROFILE_PARTICLES);
+    updateParticles(game, deltaTime);
+    profileEnd(PROFILE_PARTICLES);
+
+    // Update screen shake (but not when game is over)
+    if (game->screenShakeTimer > 0 && !game->gameOver) {
+        game->screenShakeTimer -= realDelta;
+        if (game->screenShakeTimer <= 0) {
+            game->screenShakeIntensity = 0.0f;
+        }
+    } else if (game->gameOver) {
+        // Stop screen shake immediately when game ends
+        game->screenShakeTimer = 0;
+        game->screenShakeIntensity = 0.0f;
+    }
+
+    // Update level transition
+    updateTransition(game, realDelta);
+
+    // Handle level completion
+    if (game->levelComplete && !game->isTransitioning) {
+        game->continuousFallTimer += deltaTime * 60;
+        if (game->continuousFallTimer >= 120) { // Wait 2 seconds before next level
+            generateNewLevel(game);
+        }
+        return; // Don't spawn new bits during level transition
+    }
+
+    // Spawn new bits continuously (faster spawning)
+    game->nextBitTimer += deltaTime * 60;
+    // Faster spawning at higher levels, down to a minimum interval
+    float spawnRate = game->difficulty.spawnInterval - game->level * game->difficulty.spawnIntervalStep;
+    if (spawnRate < game->difficulty.spawnIntervalMin) spawnRate = game->difficulty.spawnIntervalMin;
+    
+    if (game->stormBitsPerTick > 0) {
+        for (int i = 0; i < game->stormBitsPerTick; i++) {
+            spawnBit(game);
+        }
+    } else if (game->nextBitTimer >= spawnRate) {
+        spawnBit(game);
+        game->nextBitTimer = 0;
+    }
+
+    // Spawn power-ups occasionally
+    game->powerUpSpawnTimer += deltaTime * 60;
+    if (game->powerUpSpawnTimer >= 300) { // Every 5 seconds
+        if (rngBelow(&game->powerUpRng, 3) == 0) { // 33% chance
+            spawnPowerUp(game);
+        }
+        game->powerUpSpawnTimer = 0;
+    }
+
+    // Update falling bits
+    float* restrict bitY = bits->y;
+    const float* restrict bitSpeed = bits->speed;
+    for (int i = 0; i < bits->count; i++) {
+        bitY[i] += bitSpeed[i] * deltaTime;
+    }
+
+    // Update power-ups
+    for (int i = 0; i < powerUps->count; i++) {
+        powerUps->y[i] += powerUps->speed[i] * deltaTime;
+    }
+
+    // Check collisions
+    profileBegin(PROFILE_COLLISIONS);
+    checkCollisions(game);
+    profileEnd(PROFILE_COLLISIONS);
+
+    // Level completion is now handled in collision detection
+}
+
+void triggerScreenShake(GameState* game, float intensity) {
+    game->screenShakeTimer = SCREEN_SHAKE_DURATION;
+    game->screenShakeIntensity = intensity;
+}
+
+void startLevelTransition(GameState* game, int nextNumber) {
+    game->isTransitioning = true;
+    game->transitionTimer = TRANSITION_DURATION;
+    game->nextLevelNumber = nextNumber;
+}
+
+void updateTransition(GameState* game, float deltaTime) {
+    if (game->isTransitioning) {
+        game->transitionTimer -= deltaTime;
+        if (game->transitionTimer <= 0) {
+            game->isTransitioning = false;
+            resetLevel(game, game->nextLevelNumber);
+        }
+    }
+}
+
+// Move the player left (-1) or right (+1) for deltaTime seconds of input
+void simMovePlayer(GameState* game, int direction, float deltaTime) {
+    float speed = game->player.speed;
+    if (game->player.hasSpeedBoost) speed *= 1.5f;
+
+    if (direction < 0 && game->player.x > GAME_AREA_X) {
+        game->player.x -= speed * deltaTime;
+    } else if (direction > 0 && game->player.x < GAME_AREA_X + GAME_AREA_WIDTH - game->player.width) {
+        game->player.x += speed * deltaTime;
+    }
+}
+
+// Track a held movement key; updateGame moves the player every tick
+void simSetMoveKey(GameState* game, int direction, bool pressed) {
+    if (direction < 0) {
+        game->moveLeft = pressed;
+    } else {
+        game->moveRight = pressed;
+    }
+}
+
+// Seed for the next initGame; the same seed replays the same game
+void simSetSeed(GameState* game, uint64_t seed) {
+    game->seed = seed;
+}
+
+// A fresh seed for when none was given; report it so the run can be repeated
+uint64_t simClockSeed(void) {
+    static uint64_t calls = 0;
+    return rngHash64(((uint64_t)time(NULL) << 20) ^ (uint64_t)clock() ^ (++calls << 48));
+}
+
+// Spawn bitsPerTick bits every tick with no on-screen cap; 0 turns it off
+void simSetBitStorm(GameState* game, int bitsPerTick) {
+    game->stormBitsPerTick = bitsPerTick > 0 ? bitsPerTick : 0;
+}
+
+Difficulty simDefaultDifficulty(void) {
+    Difficulty difficulty = {
+        .spawnInterval = 30.0f,
+        .spawnIntervalStep = 2.0f,
+        .spawnIntervalMin = 10.0f,
+        .fallSpeed = 80.0f,
+        .fallSpeedStep = 15.0f,
+        .gameSpeedStep = 0.1f,
+        .startMax = 50,
+        .rangeLevels = {3, 6, 10},
+        .rangeMax = {100, 250, 500, 1000},
+    };
+    return difficulty;
+}
+
+// Kept across initGame calls, like the other settings
+void simSetDifficulty(GameState* game, const Difficulty* difficulty) {
+    game->difficulty = *difficulty;
+    game->customDifficulty = true;
+}
+
+void simFree(GameState* game) {
+    bitPoolFree(&game->fallingBits);
+    powerUpPoolFree(&game->powerUps);
+    particlePoolFree(&game->particles);
+    broadphaseFree(&game->bitGrid);
+    broadphaseFree(&game->powerUpGrid);
+}
+
+void simTogglePause(GameState* game) {
+    game->paused = !game->paused;
+}
+
+void simQuit(GameState* game) {
+    game->gameOver = true;
+}
+
+void simApplyInput(GameState* game, SimInput input) {
+    switch (input) {
+        case SIM_INPUT_LEFT_RELEASE: simSetMoveKey(game, -1, false); break;
+        case SIM_INPUT_LEFT_PRESS: simSetMoveKey(game, -1, true); break;
+        case SIM_INPUT_RIGHT_RELEASE: simSetMoveKey(game, 1, false); break;
+        case SIM_INPUT_RIGHT_PRESS: simSetMoveKey(game, 1, true); break;
+        case SIM_INPUT_PAUSE: simTogglePause(game); break;
+        case SIM_INPUT_QUIT: simQuit(game); break;
+        default: break;
+    }
+}
+
+// Events beyond SIM_MAX_EVENTS in one update are dropped; they only drive sound
+void simPushEvent(GameState* game, SimEvent event) {
+    if (game->eventCount < SIM_MAX_EVENTS) {
+        game->events[game->eventCount++] = event;
+    }
+}
+
+void simClearEvents(GameState* game) {
+    game->eventCount = 0;
+}
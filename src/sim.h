@@ -0,0 +1,303 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "binary.h"
+#include "rng.h"
+
+// Game simulation core: plain C with no SDL, TTF or mixer dependency, so
+// it can be driven by the GUI or run headless.
+
+// Play field
+#define GAME_AREA_WIDTH 600
+#define GAME_AREA_HEIGHT 500
+#define GAME_AREA_X 100
+#define GAME_AREA_Y 80
+
+// Game constants
+#define MAX_BITS BITVEC_MAX_BITS
+#define MAX_NUMBER_DIGITS ((MAX_BITS + 2) / 3) // octal needs the most digits
+#define PLAYER_WIDTH 60
+#define PLAYER_HEIGHT 20
+#define BIT_SIZE 30
+#define MAX_FALLING_BITS 5 // on screen at once, outside bit storm mode
+#define MAX_POWERUPS 3
+#define POWERUP_SIZE 25
+
+// The simulation always advances in fixed ticks; front ends accumulate real
+// time and interpolate rendering between the last two ticks
+#define SIM_TICK_RATE 60
+#define SIM_TICK_SECONDS (1.0f / SIM_TICK_RATE)
+
+// Colors
+typedef struct {
+    uint8_t r, g, b, a;
+} Color;
+
+extern const Color COLOR_WHITE;
+extern const Color COLOR_BLACK;
+extern const Color COLOR_RED;
+extern const Color COLOR_GREEN;
+extern const Color COLOR_BLUE;
+extern const Color COLOR_YELLOW;
+extern const Color COLOR_CYAN;
+extern const Color COLOR_MAGENTA;
+extern const Color COLOR_ORANGE;
+extern const Color COLOR_PURPLE;
+
+// Entity pools: growable structure-of-arrays storage. Live entities are
+// always packed in [0, count); removing one moves the last entity into its
+// slot, so spawn and remove are O(1), the free slots are simply the tail,
+// and update loops run over contiguous per-field arrays. Streams are
+// allocated on first use and reused until simFree.
+#define POOL_INITIAL_CAPACITY 64
+
+typedef struct {
+    float* x;
+    float* y;
+    float* prevX; // position at the previous tick, for interpolation
+    float* prevY;
+    float* speed;
+    uint8_t* value; // 0 or 1
+    int count;
+    int capacity;
+} BitPool;
+
+typedef struct {
+    float* x;
+    float* y;
+    float* prevX;
+    float* prevY;
+    float* speed;
+    uint8_t* type; // 0: speed boost, 1: score multiplier, 2: slow time
+    float* duration; // seconds
+    int count;
+    int capacity;
+} PowerUpPool;
+
+// Game structures
+typedef struct {
+    float x;
+    float prevX;
+    int width;
+    float speed;
+    int lives;
+    bool hasSpeedBoost;
+    bool hasScoreMultiplier;
+    bool hasSlowTime;
+    float powerUpTimer[3]; // seconds left for each power-up type
+} Player;
+
+#define SCREEN_SHAKE_DURATION 0.5f // seconds
+#define TRANSITION_DURATION 1.0f // seconds
+#define POWERUP_DURATION 5.0f // seconds
+#define WRONG_BIT_PENALTY_DURATION 1.0f // seconds
+
+// Particle types
+typedef enum {
+    PARTICLE_BIT_COLLECT,
+    PARTICLE_WRONG_BIT,
+    PARTICLE_LEVEL_COMPLETE,
+    PARTICLE_POWERUP
+} ParticleType;
+
+typedef struct {
+    float* x;
+    float* y;
+    float* vx; // velocity in pixels per second
+    float* vy;
+    float* life; // remaining life (0-1)
+    float* size;
+    Color* color;
+    int count;
+    int capacity;
+} ParticlePool;
+
+// Collision broadphase: a uniform grid of GRID_CELL_SIZE columns over the
+// play field, restricted to the player's band at the bottom. One linear
+// pass drops everything above the band and buckets the rest by column
+// (counting sort), so a query for the player's x range is a contiguous
+// slice and the narrow phase only sees entities that can actually touch.
+#define GRID_CELL_SIZE 32
+#define GRID_COLUMNS ((GAME_AREA_WIDTH + GRID_CELL_SIZE - 1) / GRID_CELL_SIZE)
+
+typedef struct {
+    int columnStart[GRID_COLUMNS + 1]; // items of column c: [columnStart[c], columnStart[c + 1])
+    int* items; // entity indices in the band, grouped by column
+    int* expired; // entities that fell past the bottom, ascending
+    int* column; // scratch: column of each entity, -1 if not in the band
+    int itemCount;
+    int expiredCount;
+    int capacity;
+} Broadphase;
+
+// Gameplay events the simulation reports instead of playing sounds itself
+typedef enum {
+    SIM_EVENT_BIT_COLLECT,
+    SIM_EVENT_WRONG_BIT,
+    SIM_EVENT_LEVEL_COMPLETE,
+    SIM_EVENT_POWERUP,
+    SIM_EVENT_GAME_OVER
+} SimEvent;
+
+#define SIM_MAX_EVENTS 32
+
+// Player inputs, as applied between ticks (and stored in replays)
+typedef enum {
+    SIM_INPUT_LEFT_RELEASE,
+    SIM_INPUT_LEFT_PRESS,
+    SIM_INPUT_RIGHT_RELEASE,
+    SIM_INPUT_RIGHT_PRESS,
+    SIM_INPUT_PAUSE,
+    SIM_INPUT_QUIT,
+    SIM_INPUT_COUNT
+} SimInput;
+
+// Difficulty curve; simDefaultDifficulty gives the shipped one. Spawn
+// intervals are in 60ths of a second (game time), fall speeds in pixels per
+// second. Level numbers are drawn from [1, rangeMax[k]] for the first k
+// with level <= rangeLevels[k], and from the last range after that.
+#define DIFFICULTY_RANGES 4
+
+typedef struct {
+    float spawnInterval;     // between bits at level 0
+    float spawnIntervalStep; // taken off per level
+    float spawnIntervalMin;
+    float fallSpeed;         // at level 0
+    float fallSpeedStep;     // added per level
+    float gameSpeedStep;     // game speed added per level after the first
+    int startMax;            // number range before the first level up
+    int rangeLevels[DIFFICULTY_RANGES - 1];
+    int rangeMax[DIFFICULTY_RANGES];
+} Difficulty;
+
+// Independent random streams; all are seeded from GameState.seed
+typedef enum {
+    SIM_STREAM_SPAWN = 1, // falling bit positions and values
+    SIM_STREAM_LEVEL,     // level numbers
+    SIM_STREAM_POWERUP,   // power-up chance, position and type
+    SIM_STREAM_COSMETIC   // particles
+} SimStream;
+
+typedef struct {
+    int originalNumber;
+    char numberDigits[MAX_NUMBER_DIGITS + 1]; // number as shown on the HUD
+    BitVector bits; // expected bits, most significant first
+    int currentBitIndex;
+    int expectedBitIndex; // Track which bit we expect next
+    BitPool fallingBits;
+    PowerUpPool powerUps;
+    Broadphase bitGrid;
+    Broadphase powerUpGrid;
+    Player player;
+    int score;
+    int level;
+    BitVector collectedBits; // correct bits caught so far, same order as bits
+    bool gameOver;
+    bool paused;
+    float gameSpeed;
+    float nextBitTimer; // in 60ths of a second
+    float powerUpSpawnTimer;
+    bool showBinaryResult;
+    bool levelComplete;
+    float wrongBitPenalty; // seconds
+    int wrongBitCount; // Track total wrong bits collected
+    float continuousFallTimer;
+    int minNumber; // Minimum number for current level
+    int maxNumber; // Maximum number for current level
+    ConversionType conversionType; // Type of conversion (decimal, octal, hex)
+
+    // Visual effects
+    ParticlePool particles;
+    int particleScale; // particles per effect are multiplied by this (stress runs)
+    float screenShakeTimer; // seconds
+    float screenShakeIntensity;
+    float transitionTimer; // seconds
+    bool isTransitioning;
+    int nextLevelNumber; // For level transitions
+
+    // Things that happened this update, for the front end (sound, etc.)
+    SimEvent events[SIM_MAX_EVENTS];
+    int eventCount;
+
+    // Movement keys currently held; applied every tick
+    bool moveLeft;
+    bool moveRight;
+
+    // Bit storm stress mode: bits spawned per tick with no on-screen cap (0 = off)
+    int stormBitsPerTick;
+
+    // Tuning; set to the defaults by initGame unless simSetDifficulty was used
+    Difficulty difficulty;
+    bool customDifficulty;
+
+    // Randomness: one seed, one stream per system, so a seed replays a game
+    // exactly and drawing in one system never shifts another
+    uint64_t seed;
+    Rng spawnRng;
+    Rng levelRng;
+    Rng powerUpRng;
+    Rng cosmeticRng;
+    uint32_t tick; // ticks simulated since initGame
+} GameState;
+
+// Simulation. A GameState must start zeroed; init functions can be called
+// again on the same state and reuse its pools until simFree. initGame
+// seeds every stream from game->seed (see simSetSeed).
+bool initGame(GameState* game, int number, ConversionType conversionType);
+bool initGameFromDigits(GameState* game, const char* digits, ConversionType conversionType);
+void updateGame(GameState* game, float deltaTime);
+void spawnBit(GameState* game);
+void spawnPowerUp(GameState* game);
+void checkCollisions(GameState* game);
+void updatePowerUps(GameState* game, float deltaTime);
+void generateNewLevel(GameState* game);
+void resetLevel(GameState* game, int newNumber);
+bool isCorrectBit(const GameState* game, int bitValue);
+void spawnParticles(GameState* game, float x, float y, ParticleType type, int count);
+void updateParticles(GameState* game, float deltaTime);
+void simSetParticleScale(GameState* game, int scale);
+void triggerScreenShake(GameState* game, float intensity);
+void startLevelTransition(GameState* game, int nextNumber);
+void updateTransition(GameState* game, float deltaTime);
+void simSetBitStorm(GameState* game, int bitsPerTick);
+Difficulty simDefaultDifficulty(void);
+void simSetDifficulty(GameState* game, const Difficulty* difficulty);
+void simSetSeed(GameState* game, uint64_t seed);
+uint64_t simClockSeed(void);
+void simFree(GameState* game);
+
+// Pool slots; Add returns the new index, or -1 if out of memory
+int bitPoolAdd(BitPool* pool);
+int powerUpPoolAdd(PowerUpPool* pool);
+int particlePoolAdd(ParticlePool* pool);
+bool particlePoolReserve(ParticlePool* pool, int count);
+bool bitPoolResize(BitPool* pool, int count);
+bool powerUpPoolResize(PowerUpPool* pool, int count);
+bool particlePoolResize(ParticlePool* pool, int count);
+void bitPoolRemove(BitPool* pool, int index);
+void powerUpPoolRemove(PowerUpPool* pool, int index);
+void bitPoolFree(BitPool* pool);
+void powerUpPoolFree(PowerUpPool* pool);
+void particlePoolFree(ParticlePool* pool);
+
+// Broadphase for entities of the given size; bandTop and floorY are screen y
+bool broadphaseBuild(Broadphase* grid, const float* x, const float* y, int count,
+                     float size, float bandTop, float floorY);
+void broadphaseColumns(float left, float right, float size, int* first, int* last);
+bool broadphaseReserve(Broadphase* grid, int count);
+void broadphaseFree(Broadphase* grid);
+
+// Player input, independent of where it comes from
+void simMovePlayer(GameState* game, int direction, float deltaTime);
+void simSetMoveKey(GameState* game, int direction, bool pressed);
+void simTogglePause(GameState* game);
+void simQuit(GameState* game);
+void simApplyInput(GameState* game, SimInput input);
+
+// Events raised since the last simClearEvents
+void simPushEvent(GameState* game, SimEvent event);
+void simClearEvents(GameState* game);
+
+#endif
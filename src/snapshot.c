@@ -0,0 +1,282 @@
+#define _POSIX_C_SOURCE 200809L
+#include "snapshot.h"
+#include "alloc.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint32_t stateSize; // sizeof(GameState) of the writing build
+    int32_t bitCount;
+    int32_t powerUpCount;
+    int32_t particleCount;
+} SnapshotHeader;
+
+static const char snapshotMagic[4] = {'B', 'Q', 'S', 'S'};
+
+#define BIT_BYTES (5 * sizeof(float) + sizeof(uint8_t))
+#define POWERUP_BYTES (6 * sizeof(float) + sizeof(uint8_t))
+#define PARTICLE_BYTES (6 * sizeof(float) + sizeof(Color))
+
+static uint8_t* put(uint8_t* out, const void* src, size_t bytes) {
+    if (bytes > 0) memcpy(out, src, bytes);
+    return out + bytes;
+}
+
+static const uint8_t* get(const uint8_t* in, void* dst, size_t bytes) {
+    if (bytes > 0) memcpy(dst, in, bytes);
+    return in + bytes;
+}
+
+static void clearMember(uint8_t* state, size_t offset, size_t bytes) {
+    memset(state + offset, 0, bytes);
+}
+
+size_t snapshotSize(const GameState* game) {
+    return sizeof(SnapshotHeader) + sizeof(GameState) +
+           (size_t)game->fallingBits.count * BIT_BYTES +
+           (size_t)game->powerUps.count * POWERUP_BYTES +
+           (size_t)game->particles.count * PARTICLE_BYTES;
+}
+
+void snapshotWrite(const GameState* game, uint8_t* out) {
+    const BitPool* bits = &game->fallingBits;
+    const PowerUpPool* powerUps = &game->powerUps;
+    const ParticlePool* particles = &game->particles;
+    SnapshotHeader header = {{0}, SNAPSHOT_VERSION, (uint32_t)sizeof(GameState),
+                             bits->count, powerUps->count, particles->count};
+    memcpy(header.magic, snapshotMagic, sizeof(snapshotMagic));
+    out = put(out, &header, sizeof(header));
+    // Pool and grid members only hold this process's allocations; clear
+    // them so identical states give identical snapshots
+    memcpy(out, game, sizeof(GameState));
+    clearMember(out, offsetof(GameState, fallingBits), sizeof(BitPool));
+    clearMember(out, offsetof(GameState, powerUps), sizeof(PowerUpPool));
+    clearMember(out, offsetof(GameState, particles), sizeof(ParticlePool));
+    clearMember(out, offsetof(GameState, bitGrid), sizeof(Broadphase));
+    clearMember(out, offsetof(GameState, powerUpGrid), sizeof(Broadphase));
+    out += sizeof(GameState);
+
+    size_t n = (size_t)bits->count * sizeof(float);
+    out = put(out, bits->x, n);
+    out = put(out, bits->y, n);
+    out = put(out, bits->prevX, n);
+    out = put(out, bits->prevY, n);
+    out = put(out, bits->speed, n);
+    out = put(out, bits->value, (size_t)bits->count);
+
+    n = (size_t)powerUps->count * sizeof(float);
+    out = put(out, powerUps->x, n);
+    out = put(out, powerUps->y, n);
+    out = put(out, powerUps->prevX, n);
+    out = put(out, powerUps->prevY, n);
+    out = put(out, powerUps->speed, n);
+    out = put(out, powerUps->duration, n);
+    out = put(out, powerUps->type, (size_t)powerUps->count);
+
+    n = (size_t)particles->count * sizeof(float);
+    out = put(out, particles->x, n);
+    out = put(out, particles->y, n);
+    out = put(out, particles->vx, n);
+    out = put(out, particles->vy, n);
+    out = put(out, particles->life, n);
+    out = put(out, particles->size, n);
+    put(out, particles->color, (size_t)particles->count * sizeof(Color));
+}
+
+// Restore in place, keeping the game's own pool and grid allocations
+bool snapshotRead(GameState* game, const uint8_t* data, size_t size) {
+    SnapshotHeader header;
+    if (size < sizeof(header)) return false;
+    data = get(data, &header, sizeof(header));
+    if (memcmp(header.magic, snapshotMagic, sizeof(snapshotMagic)) != 0 ||
+        header.version != SNAPSHOT_VERSION || header.stateSize != sizeof(GameState) ||
+        header.bitCount < 0 || header.powerUpCount < 0 || header.particleCount < 0) {
+        return false;
+    }
+    size_t expected = sizeof(header) + sizeof(GameState) +
+                      (size_t)header.bitCount * BIT_BYTES +
+                      (size_t)header.powerUpCount * POWERUP_BYTES +
+                      (size_t)header.particleCount * PARTICLE_BYTES;
+    if (size != expected) return false;
+
+    BitPool bits = game->fallingBits;
+    PowerUpPool powerUps = game->powerUps;
+    ParticlePool particles = game->particles;
+    if (!bitPoolResize(&bits, header.bitCount) ||
+        !powerUpPoolResize(&powerUps, header.powerUpCount) ||
+        !particlePoolResize(&particles, header.particleCount)) {
+        // Keep whatever grew so it is still freed with the game
+        bits.count = game->fallingBits.count;
+        powerUps.count = game->powerUps.count;
+        particles.count = game->particles.count;
+        game->fallingBits = bits;
+        game->powerUps = powerUps;
+        game->particles = particles;
+        return false;
+    }
+    Broadphase bitGrid = game->bitGrid;
+    Broadphase powerUpGrid = game->powerUpGrid;
+
+    data = get(data, game, sizeof(GameState));
+    game->fallingBits = bits;
+    game->powerUps = powerUps;
+    game->particles = particles;
+    game->bitGrid = bitGrid;
+    game->powerUpGrid = powerUpGrid;
+
+    size_t n = (size_t)bits.count * sizeof(float);
+    data = get(data, bits.x, n);
+    data = get(data, bits.y, n);
+    data = get(data, bits.prevX, n);
+    data = get(data, bits.prevY, n);
+    data = get(data, bits.speed, n);
+    data = get(data, bits.value, (size_t)bits.count);
+
+    n = (size_t)powerUps.count * sizeof(float);
+    data = get(data, powerUps.x, n);
+    data = get(data, powerUps.y, n);
+    data = get(data, powerUps.prevX, n);
+    data = get(data, powerUps.prevY, n);
+    data = get(data, powerUps.speed, n);
+    data = get(data, powerUps.duration, n);
+    data = get(data, powerUps.type, (size_t)powerUps.count);
+
+    n = (size_t)particles.count * sizeof(float);
+    data = get(data, particles.x, n);
+    data = get(data, particles.y, n);
+    data = get(data, particles.vx, n);
+    data = get(data, particles.vy, n);
+    data = get(data, particles.life, n);
+    data = get(data, particles.size, n);
+    get(data, particles.color, (size_t)particles.count * sizeof(Color));
+    return true;
+}
+
+#ifndef _WIN32
+
+bool snapshotSave(const GameState* game, const char* path) {
+    size_t size = snapshotSize(game);
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+    if (ftruncate(fd, (off_t)size) != 0) {
+        close(fd);
+        return false;
+    }
+    void* map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return false;
+    snapshotWrite(game, map);
+    return munmap(map, size) == 0;
+}
+
+bool snapshotLoad(GameState* game, const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+    size_t size = (size_t)info.st_size;
+    void* map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return false;
+    bool ok = snapshotRead(game, map, size);
+    munmap(map, size);
+    return ok;
+}
+
+#else
+
+// No mmap on Windows builds; plain buffered IO gives the same file
+bool snapshotSave(const GameState* game, const char* path) {
+    size_t size = snapshotSize(game);
+    uint8_t* data = TRACKED_MALLOC(size);
+    if (!data) return false;
+    snapshotWrite(game, data);
+    FILE* file = fopen(path, "wb");
+    bool ok = file && fwrite(data, 1, size, file) == size;
+    if (file && fclose(file) != 0) ok = false;
+    TRACKED_FREE(data);
+    return ok;
+}
+
+bool snapshotLoad(GameState* game, const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    uint8_t* data = size > 0 ? TRACKED_MALLOC((size_t)size) : NULL;
+    bool ok = data && fread(data, 1, (size_t)size, file) == (size_t)size &&
+              snapshotRead(game, data, (size_t)size);
+    fclose(file);
+    TRACKED_FREE(data);
+    return ok;
+}
+
+#endif
+
+bool snapshotRingInit(SnapshotRing* ring, int capacity) {
+    *ring = (SnapshotRing){0};
+    ring->slots = TRACKED_CALLOC((size_t)capacity, sizeof(SnapshotSlot));
+    if (!ring->slots) return false;
+    ring->capacity = capacity;
+    ring->newest = capacity - 1;
+    return true;
+}
+
+bool snapshotRingPush(SnapshotRing* ring, const GameState* game) {
+    if (ring->capacity == 0) return false;
+    int index = (ring->newest + 1) % ring->capacity;
+    SnapshotSlot* slot = &ring->slots[index];
+    size_t size = snapshotSize(game);
+    if (size > slot->capacity) {
+        size_t capacity = slot->capacity > 0 ? slot->capacity : size;
+        while (capacity < size) capacity *= 2;
+        uint8_t* data = TRACKED_REALLOC(slot->data, capacity);
+        if (!data) return false;
+        slot->data = data;
+        slot->capacity = capacity;
+    }
+    snapshotWrite(game, slot->data);
+    slot->size = size;
+    ring->newest = index;
+    if (ring->count < ring->capacity) ring->count++;
+    return true;
+}
+
+// Go back steps pushes (clamped to the oldest kept) and drop everything
+// newer; returns how many steps were taken
+int snapshotRingRewind(SnapshotRing* ring, GameState* game, int steps) {
+    if (ring->count == 0) return 0;
+    if (steps > ring->count - 1) steps = ring->count - 1;
+    int index = ((ring->newest - steps) % ring->capacity + ring->capacity) % ring->capacity;
+    SnapshotSlot* slot = &ring->slots[index];
+    if (!snapshotRead(game, slot->data, slot->size)) return 0;
+    ring->newest = index;
+    ring->count -= steps;
+    return steps;
+}
+
+void snapshotRingClear(SnapshotRing* ring) {
+    ring->count = 0;
+}
+
+void snapshotRingFree(SnapshotRing* ring) {
+    for (int i = 0; i < ring->capacity; i++) {
+        TRACKED_FREE(ring->slots[i].data);
+    }
+    TRACKED_FREE(ring->slots);
+    *ring = (SnapshotRing){0};
+}
@@ -0,0 +1,49 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "sim.h"
+
+// GameState snapshots. A snapshot is one flat block: a small header, the
+// GameState struct itself and then the live part of every pool stream.
+// Pool pointers inside the copied struct are ignored on restore and the
+// collision grids are skipped, since checkCollisions rebuilds them. Both
+// directions are a handful of memcpys, cheap enough to take every tick.
+//
+// Snapshots are tied to the build that wrote them (the header records the
+// GameState size), which is all rewind and quick save/load need.
+
+#define SNAPSHOT_VERSION 1
+
+size_t snapshotSize(const GameState* game);
+void snapshotWrite(const GameState* game, uint8_t* out);
+bool snapshotRead(GameState* game, const uint8_t* data, size_t size);
+
+// Disk save/restore through a memory-mapped file
+bool snapshotSave(const GameState* game, const char* path);
+bool snapshotLoad(GameState* game, const char* path);
+
+// Ring of the most recent snapshots, one per push, for rewinding. Slot
+// buffers are kept and reused, so a full ring pushes without allocating.
+typedef struct {
+    uint8_t* data;
+    size_t size;
+    size_t capacity;
+} SnapshotSlot;
+
+typedef struct {
+    SnapshotSlot* slots;
+    int capacity;
+    int newest; // slot of the latest push
+    int count;
+} SnapshotRing;
+
+bool snapshotRingInit(SnapshotRing* ring, int capacity);
+bool snapshotRingPush(SnapshotRing* ring, const GameState* game);
+int snapshotRingRewind(SnapshotRing* ring, GameState* game, int steps);
+void snapshotRingClear(SnapshotRing* ring);
+void snapshotRingFree(SnapshotRing* ring);
+
+#endif
@@ -1,4 +1,6 @@
 #include "sound.h"
+#include "trace.h"
+#include "alloc.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/stat.h>
@@ -35,6 +37,7 @@ void soundCleanup(SoundSystem* sound) {
     // Free sound effects
     for (int i = 0; i < SOUND_COUNT; i++) {
         if (sound->soundEffects[i]) {
+            allocNoteFree(ALLOC_MIXER, sound->soundEffects[i]->alen);
             Mix_FreeChunk(sound->soundEffects[i]);
             sound->soundEffects[i] = NULL;
         }
@@ -43,6 +46,7 @@ void soundCleanup(SoundSystem* sound) {
     // Free music
     for (int i = 0; i < MUSIC_COUNT; i++) {
         if (sound->music[i]) {
+            allocNoteFree(ALLOC_MIXER, 0);
             Mix_FreeMusic(sound->music[i]);
             sound->music[i] = NULL;
         }
@@ -52,6 +56,7 @@ void soundCleanup(SoundSystem* sound) {
 }
 
 bool soundLoadEffects(SoundSystem* sound, const char* soundPath) {
+    TRACE_FUNCTION();
     char filepath[256];
     
     // Check if sounds directory exists
@@ -77,6 +82,10 @@ bool soundLoadEffects(SoundSystem* sound, const char* soundPath) {
     snprintf(filepath, sizeof(filepath), "%s/menu_select.wav", soundPath);
     sound->soundEffects[SOUND_MENU_SELECT] = Mix_LoadWAV(filepath);
 
+    for (int i = 0; i < SOUND_COUNT; i++) {
+        if (sound->soundEffects[i]) allocNote(ALLOC_MIXER, sound->soundEffects[i]->alen, ALLOC_SITE);
+    }
+
     // Only show warnings if sounds directory exists
     if (soundDirExists) {
         for (int i = 0; i < SOUND_COUNT; i++) {
@@ -108,6 +117,11 @@ bool soundLoadMusic(SoundSystem* sound, const char* musicPath) {
     snprintf(filepath, sizeof(filepath), "%s/gameover.mp3", musicPath);
     sound->music[MUSIC_GAME_OVER] = Mix_LoadMUS(filepath);
 
+    // Music is streamed; only the count is tracked
+    for (int i = 0; i < MUSIC_COUNT; i++) {
+        if (sound->music[i]) allocNote(ALLOC_MIXER, 0, ALLOC_SITE);
+    }
+
     // Only show warnings if sounds directory exists
     if (soundDirExists) {
         for (int i = 0; i < MUSIC_COUNT; i++) {
@@ -121,6 +135,7 @@ bool soundLoadMusic(SoundSystem* sound, const char* musicPath) {
 }
 
 void soundPlayEffect(SoundSystem* sound, SoundEffect effect) {
+    TRACE_FUNCTION();
     if (!sound->soundEnabled || !sound->soundEffects[effect]) {
         printf("❌ Cannot play sound effect %d: soundEnabled=%d, soundEffects[%d]=%p\n", 
                effect, sound->soundEnabled, effect, sound->soundEffects[effect]);
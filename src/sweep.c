@@ -0,0 +1,260 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include "batch.h"
+#include "workpool.h"
+
+// Difficulty sweep: every point of a parameter grid plays the same set of
+// games (game n uses seed + n at each point, so points differ only by
+// their parameters) under a bot input model. Tasks are small batches of
+// games spread over the work-stealing pool, and the per-point summary is
+// written as CSV, one row per point.
+
+#define DEFAULT_GAMES 200
+#define GAMES_PER_TASK 8
+#define MAX_AXES 8
+#define MAX_AXIS_VALUES 1024
+
+typedef struct {
+    const char* name;
+    size_t offset; // float field of Difficulty; unused for range-scale
+    const char* help;
+} SweepParam;
+
+static const SweepParam sweepParams[] = {
+    {"spawn-interval", offsetof(Difficulty, spawnInterval), "spawn interval at level 0 (60ths of a second)"},
+    {"spawn-step", offsetof(Difficulty, spawnIntervalStep), "spawn interval taken off per level"},
+    {"spawn-min", offsetof(Difficulty, spawnIntervalMin), "shortest spawn interval"},
+    {"fall-speed", offsetof(Difficulty, fallSpeed), "bit fall speed at level 0 (pixels per second)"},
+    {"fall-step", offsetof(Difficulty, fallSpeedStep), "fall speed added per level"},
+    {"speed-step", offsetof(Difficulty, gameSpeedStep), "game speed added per level"},
+    {"range-scale", 0, "multiplier on every level number range"},
+};
+#define SWEEP_PARAM_COUNT (int)(sizeof(sweepParams) / sizeof(sweepParams[0]))
+
+typedef struct {
+    const SweepParam* param;
+    float* values;
+    int count;
+} SweepAxis;
+
+typedef struct {
+    SweepAxis axes[MAX_AXES];
+    int axisCount;
+    int pointCount;
+    int tasksPerPoint;
+    BatchOptions options;    // options.games is the games per point
+    GameResult* results;     // pointCount * gamesPerPoint, by point then game
+    GameState* workerGames;  // one per worker, pools reused across games
+} Sweep;
+
+static const SweepParam* findParam(const char* name, size_t length) {
+    for (int i = 0; i < SWEEP_PARAM_COUNT; i++) {
+        if (strlen(sweepParams[i].name) == length && strncmp(sweepParams[i].name, name, length) == 0) {
+            return &sweepParams[i];
+        }
+    }
+    return NULL;
+}
+
+// NAME=a,b,c or NAME=start:stop:step (stop included)
+static bool parseAxis(SweepAxis* axis, const char* spec) {
+    const char* equals = strchr(spec, '=');
+    if (!equals) return false;
+    axis->param = findParam(spec, (size_t)(equals - spec));
+    if (!axis->param) return false;
+    axis->values = malloc(MAX_AXIS_VALUES * sizeof(float));
+    if (!axis->values) return false;
+    axis->count = 0;
+
+    const char* list = equals + 1;
+    float start, stop, step;
+    if (strchr(list, ':')) {
+        if (sscanf(list, "%f:%f:%f", &start, &stop, &step) != 3 || step <= 0.0f) return false;
+        for (int i = 0; start + i * step <= stop + step * 1e-3f && axis->count < MAX_AXIS_VALUES; i++) {
+            axis->values[axis->count++] = start + i * step;
+        }
+    } else {
+        const char* s = list;
+        while (*s && axis->count < MAX_AXIS_VALUES) {
+            char* end;
+            axis->values[axis->count++] = strtof(s, &end);
+            if (end == s) return false;
+            s = *end == ',' ? end + 1 : end;
+        }
+    }
+    return axis->count > 0;
+}
+
+// Values of each axis at a point; the first axis varies slowest
+static void pointValues(const Sweep* sweep, int point, float* values) {
+    for (int a = sweep->axisCount - 1; a >= 0; a--) {
+        const SweepAxis* axis = &sweep->axes[a];
+        values[a] = axis->values[point % axis->count];
+        point /= axis->count;
+    }
+}
+
+static Difficulty pointDifficulty(const Sweep* sweep, int point) {
+    Difficulty difficulty = simDefaultDifficulty();
+    float values[MAX_AXES];
+    pointValues(sweep, point, values);
+    for (int a = 0; a < sweep->axisCount; a++) {
+        const SweepParam* param = sweep->axes[a].param;
+        if (strcmp(param->name, "range-scale") == 0) {
+            difficulty.startMax = (int)(difficulty.startMax * values[a]);
+            for (int r = 0; r < DIFFICULTY_RANGES; r++) {
+                difficulty.rangeMax[r] = (int)(difficulty.rangeMax[r] * values[a]);
+            }
+        } else {
+            *(float*)((char*)&difficulty + param->offset) = values[a];
+        }
+    }
+    if (difficulty.startMax < 1) difficulty.startMax = 1;
+    for (int r = 0; r < DIFFICULTY_RANGES; r++) {
+        if (difficulty.rangeMax[r] < 1) difficulty.rangeMax[r] = 1;
+    }
+    return difficulty;
+}
+
+static void runTask(void* context, int task, int worker) {
+    Sweep* sweep = context;
+    GameState* game = &sweep->workerGames[worker];
+    int point = task / sweep->tasksPerPoint;
+    int first = (task % sweep->tasksPerPoint) * GAMES_PER_TASK;
+    int last = first + GAMES_PER_TASK;
+    if (last > sweep->options.games) last = sweep->options.games;
+
+    Difficulty difficulty = pointDifficulty(sweep, point);
+    simSetDifficulty(game, &difficulty);
+    for (int n = first; n < last; n++) {
+        GameResult* result = &sweep->results[(size_t)point * sweep->options.games + n];
+        batchPlayGame(game, &sweep->options, n, result);
+    }
+}
+
+static void writeTable(const Sweep* sweep, FILE* out) {
+    for (int a = 0; a < sweep->axisCount; a++) {
+        fprintf(out, "%s,", sweep->axes[a].param->name);
+    }
+    fprintf(out, "games,mean_level,p10_level,p50_level,p90_level,mean_score,p50_score,mean_seconds,capped\n");
+
+    int games = sweep->options.games;
+    int* levels = malloc((size_t)games * sizeof(int));
+    int* scores = malloc((size_t)games * sizeof(int));
+    if (!levels || !scores) {
+        free(levels);
+        free(scores);
+        return;
+    }
+    for (int point = 0; point < sweep->pointCount; point++) {
+        const GameResult* results = &sweep->results[(size_t)point * games];
+        double levelSum = 0.0, scoreSum = 0.0, tickSum = 0.0;
+        int capped = 0;
+        for (int n = 0; n < games; n++) {
+            levels[n] = results[n].level;
+            scores[n] = results[n].score;
+            levelSum += results[n].level;
+            scoreSum += results[n].score;
+            tickSum += results[n].ticks;
+            if (results[n].capped) capped++;
+        }
+        qsort(levels, games, sizeof(int), batchCompareInts);
+        qsort(scores, games, sizeof(int), batchCompareInts);
+
+        float values[MAX_AXES];
+        pointValues(sweep, point, values);
+        for (int a = 0; a < sweep->axisCount; a++) {
+            fprintf(out, "%g,", values[a]);
+        }
+        fprintf(out, "%d,%.3f,%d,%d,%d,%.1f,%d,%.1f,%d\n", games, levelSum / games,
+                levels[games / 10], levels[games / 2], levels[games * 9 / 10],
+                scoreSum / games, scores[games / 2], tickSum / games / SIM_TICK_RATE, capped);
+    }
+    free(levels);
+    free(scores);
+}
+
+static void printUsage(const char* program) {
+    printf("Usage: %s --vary NAME=LIST [--vary ...] [options]\n", program);
+    printf("LIST is a,b,c or start:stop:step. Parameters (defaults from the game):\n");
+    for (int i = 0; i < SWEEP_PARAM_COUNT; i++) {
+        printf("  %-15s %s\n", sweepParams[i].name, sweepParams[i].help);
+    }
+    printf("Options:\n");
+    printf("  --games N        games per point (default: %d)\n", DEFAULT_GAMES);
+    printf("  --threads N      worker threads (default: all cores)\n");
+    printf("  --input bot|sweep  input model (default: bot)\n");
+    printf("  --number N       starting number (default: 42)\n");
+    printf("  --type dec|oct|hex\n");
+    printf("  --seed N         game n uses seed + n at every point (default: from the clock)\n");
+    printf("  --max-minutes N  cut games off after N minutes of play (default: %d)\n", BATCH_DEFAULT_MAX_MINUTES);
+    printf("  --out FILE       write the CSV table here (default: stdout)\n");
+}
+
+int main(int argc, char* argv[]) {
+    static Sweep sweep;
+    BatchOptions* options = &sweep.options;
+    batchDefaultOptions(options, DEFAULT_GAMES);
+    const char* outPath = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--vary") == 0 && i + 1 < argc) {
+            if (sweep.axisCount == MAX_AXES || !parseAxis(&sweep.axes[sweep.axisCount], argv[++i])) {
+                printf("Bad --vary: %s\n", argv[i]);
+                return 1;
+            }
+            sweep.axisCount++;
+        } else if (strcmp(argv[i], "--input") == 0 && i + 1 < argc) {
+            options->model = strcmp(argv[++i], "sweep") == 0 ? BOT_SWEEP : BOT_AUTOPLAY;
+        } else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            outPath = argv[++i];
+        } else if (!batchParseOption(options, argc, argv, &i)) {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (!batchCheckOptions(options)) return 1;
+
+    // No --vary sweeps the single default point
+    long points = 1;
+    for (int a = 0; a < sweep.axisCount; a++) {
+        points *= sweep.axes[a].count;
+        if (points > 1000000) {
+            printf("Grid too large (over a million points)\n");
+            return 1;
+        }
+    }
+    sweep.pointCount = (int)points;
+    sweep.tasksPerPoint = (options->games + GAMES_PER_TASK - 1) / GAMES_PER_TASK;
+
+    FILE* out = outPath ? fopen(outPath, "w") : stdout;
+    sweep.results = calloc((size_t)sweep.pointCount * options->games, sizeof(GameResult));
+    sweep.workerGames = calloc((size_t)options->threads, sizeof(GameState));
+    if (!out || !sweep.results || !sweep.workerGames) {
+        printf(out ? "bqsweep: out of memory\n" : "Could not open output file\n");
+        return 1;
+    }
+
+    double start = batchNowSeconds();
+    int started = workPoolRun(sweep.pointCount * sweep.tasksPerPoint, (int)options->threads, runTask, &sweep);
+    double elapsed = batchNowSeconds() - start;
+
+    writeTable(&sweep, out);
+    if (outPath) fclose(out);
+    long long games = (long long)sweep.pointCount * options->games;
+    fprintf(stderr, "Swept %d points x %d games on %d threads in %.2f s (%.0f games/s)\n",
+            sweep.pointCount, options->games, started, elapsed, elapsed > 0 ? games / elapsed : 0.0);
+
+    for (long i = 0; i < options->threads; i++) {
+        simFree(&sweep.workerGames[i]);
+    }
+    for (int a = 0; a < sweep.axisCount; a++) {
+        free(sweep.axes[a].values);
+    }
+    free(sweep.workerGames);
+    free(sweep.results);
+    return 0;
+}
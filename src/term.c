@@ -0,0 +1,153 @@
+#define _POSIX_C_SOURCE 200809L
+#include <errno.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "term.h"
+
+// Unchanged cells shorter than this between two changes are resent rather
+// than skipped with a cursor move (which costs at least six bytes)
+#define TERM_GAP_RESEND 6
+
+bool termInit(TermRenderer* term, int width, int height){
+    memset(term, 0, sizeof(*term));
+    size_t cells = (size_t)width * height;
+    term->front = malloc(cells);
+    term->back = malloc(cells);
+    term->outCapacity = cells * 2 + 64;
+    term->out = malloc(term->outCapacity);
+    if (!term->front || !term->back || !term->out) {
+        termFree(term);
+        return false;
+    }
+    term->width = width;
+    term->height = height;
+    memset(term->front, ' ', cells);
+    memset(term->back, ' ', cells);
+    term->fullRedraw = true;
+    return true;
+}
+
+void termFree(TermRenderer* term){
+    free(term->front);
+    free(term->back);
+    free(term->out);
+    memset(term, 0, sizeof(*term));
+}
+
+void termClear(TermRenderer* term){
+    memset(term->back, ' ', (size_t)term->width * term->height);
+}
+
+void termPut(TermRenderer* term, int x, int y, char c){
+    if (x < 0 || y < 0 || x >= term->width || y >= term->height) return;
+    term->back[(size_t)y * term->width + x] = c;
+}
+
+void termText(TermRenderer* term, int x, int y, const char* text){
+    for (; *text; text++, x++) {
+        termPut(term, x, y, *text);
+    }
+}
+
+static bool outReserve(TermRenderer* term, size_t extra){
+    if (term->outLength + extra <= term->outCapacity) return true;
+    size_t capacity = term->outCapacity * 2;
+    while (capacity < term->outLength + extra) capacity *= 2;
+    char* out = realloc(term->out, capacity);
+    if (!out) return false;
+    term->out = out;
+    term->outCapacity = capacity;
+    return true;
+}
+
+// A frame that does not fit is dropped and the next one repainted in full
+static void outBytes(TermRenderer* term, const char* bytes, size_t length){
+    if (!outReserve(term, length)) {
+        term->fullRedraw = true;
+        return;
+    }
+    memcpy(term->out + term->outLength, bytes, length);
+    term->outLength += length;
+}
+
+static void outMove(TermRenderer* term, int x, int y){
+    char move[32];
+    int length = snprintf(move, sizeof(move), "\x1b[%d;%dH", y + 1, x + 1);
+    outBytes(term, move, (size_t)length);
+}
+
+// The terminal may share a non-blocking file description with stdin
+static bool writeAll(int fd, const char* data, size_t length){
+    while (length > 0) {
+        ssize_t written = write(fd, data, length);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                struct pollfd wait = {fd, POLLOUT, 0};
+                poll(&wait, 1, -1);
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        length -= (size_t)written;
+    }
+    return true;
+}
+
+long termPresent(TermRenderer* term, int fd){
+    term->outLength = 0;
+    if (term->fullRedraw) {
+        // Hide the cursor and clear once; the screen is then all blanks
+        term->fullRedraw = false;
+        outBytes(term, "\x1b[?25l\x1b[2J", 10);
+        memset(term->front, ' ', (size_t)term->width * term->height);
+    }
+
+    for (int y = 0; y < term->height; y++) {
+        const char* front = term->front + (size_t)y * term->width;
+        const char* back = term->back + (size_t)y * term->width;
+        int x = 0;
+        while (x < term->width) {
+            if (front[x] == back[x]) {
+                x++;
+                continue;
+            }
+            // Run of changes, absorbing short unchanged gaps
+            int start = x;
+            int end = x + 1;
+            int gap = 0;
+            for (int i = end; i < term->width && gap < TERM_GAP_RESEND; i++) {
+                if (front[i] != back[i]) {
+                    end = i + 1;
+                    gap = 0;
+                } else {
+                    gap++;
+                }
+            }
+            outMove(term, start, y);
+            outBytes(term, back + start, (size_t)(end - start));
+            x = end;
+        }
+    }
+    if (term->fullRedraw) return -1; // out of memory; front is left as it was
+    memcpy(term->front, term->back, (size_t)term->width * term->height);
+
+    if (term->outLength == 0) return 0;
+    if (!writeAll(fd, term->out, term->outLength)) {
+        term->fullRedraw = true;
+        return -1;
+    }
+    return (long)term->outLength;
+}
+
+void termRestore(TermRenderer* term, int fd){
+    term->outLength = 0;
+    outMove(term, 0, term->height);
+    outBytes(term, "\x1b[?25h", 6);
+    writeAll(fd, term->out, term->outLength);
+    term->fullRedraw = true;
+}
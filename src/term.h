@@ -0,0 +1,37 @@
+#ifndef TERM_H
+#define TERM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Double-buffered ANSI terminal renderer. A frame is composed into the
+// back buffer, then termPresent compares it with what the terminal already
+// shows and sends only the changed cells, as cursor moves plus text, in a
+// single write(). Any frame size works; nothing is cleared between frames.
+
+typedef struct {
+    int width;
+    int height;
+    char* front;       // cells the terminal currently shows
+    char* back;        // cells of the frame being composed
+    char* out;         // escape sequences for one present
+    size_t outLength;
+    size_t outCapacity;
+    bool fullRedraw;   // next present repaints everything
+} TermRenderer;
+
+bool termInit(TermRenderer* term, int width, int height);
+void termFree(TermRenderer* term);
+
+// Composing; everything is clipped to the frame
+void termClear(TermRenderer* term);
+void termPut(TermRenderer* term, int x, int y, char c);
+void termText(TermRenderer* term, int x, int y, const char* text);
+
+// Returns the bytes written, or -1 on error (the next present then
+// repaints the whole frame)
+long termPresent(TermRenderer* term, int fd);
+// Show the cursor again and park it below the frame
+void termRestore(TermRenderer* term, int fd);
+
+#endif
@@ -0,0 +1,148 @@
+#include "text_atlas.h"
+#include "alloc.h"
+#include <stdio.h>
+#include <string.h>
+
+#define BULLET_CODEPOINT 0x2022
+
+static Uint16 glyphCodepoint(int slot) {
+    return slot == TEXT_ATLAS_BULLET ? BULLET_CODEPOINT : (Uint16)(TEXT_ATLAS_FIRST_CHAR + slot);
+}
+
+// Next atlas slot from a UTF-8 string; unknown characters draw as '?'
+static int nextGlyphSlot(const unsigned char** text) {
+    const unsigned char* s = *text;
+    unsigned codepoint = *s++;
+    if (codepoint >= 0x80) {
+        int extra = codepoint >= 0xF0 ? 3 : codepoint >= 0xE0 ? 2 : 1;
+        codepoint &= 0x3F >> extra;
+        while (extra-- > 0 && (*s & 0xC0) == 0x80) {
+            codepoint = (codepoint << 6) | (*s++ & 0x3F);
+        }
+    }
+    *text = s;
+
+    if (codepoint >= TEXT_ATLAS_FIRST_CHAR && codepoint <= TEXT_ATLAS_LAST_CHAR) {
+        return (int)codepoint - TEXT_ATLAS_FIRST_CHAR;
+    }
+    if (codepoint == BULLET_CODEPOINT) {
+        return TEXT_ATLAS_BULLET;
+    }
+    return '?' - TEXT_ATLAS_FIRST_CHAR;
+}
+
+// Surfaces and the atlas texture are reported to the allocation tracker
+static size_t surfaceBytes(const SDL_Surface* surface) {
+    return (size_t)surface->pitch * surface->h;
+}
+
+static void freeSurface(SDL_Surface* surface) {
+    allocNoteFree(ALLOC_SURFACE, surfaceBytes(surface));
+    SDL_FreeSurface(surface);
+}
+
+bool textAtlasCreate(TextAtlas* atlas, SDL_Renderer* renderer, TTF_Font* font) {
+    memset(atlas, 0, sizeof(*atlas));
+    if (!font) return false;
+
+    // Rasterize every glyph white; color is applied per vertex when drawing
+    SDL_Color white = {255, 255, 255, 255};
+    SDL_Surface* rendered[TEXT_ATLAS_GLYPHS];
+    int penX = 0, penY = 0, rowHeight = 0;
+    for (int i = 0; i < TEXT_ATLAS_GLYPHS; i++) {
+        rendered[i] = TTF_RenderGlyph_Blended(font, glyphCodepoint(i), white);
+        if (rendered[i]) allocNote(ALLOC_SURFACE, surfaceBytes(rendered[i]), ALLOC_SITE);
+        int advance = 0;
+        TTF_GlyphMetrics(font, glyphCodepoint(i), NULL, NULL, NULL, NULL, &advance);
+        atlas->glyphs[i].advance = advance;
+        if (!rendered[i]) continue;
+
+        if (penX + rendered[i]->w > TEXT_ATLAS_WIDTH) {
+            penX = 0;
+            penY += rowHeight + 1;
+            rowHeight = 0;
+        }
+        atlas->glyphs[i].source = (SDL_Rect){penX, penY, rendered[i]->w, rendered[i]->h};
+        penX += rendered[i]->w + 1;
+        if (rendered[i]->h > rowHeight) rowHeight = rendered[i]->h;
+    }
+    int atlasHeight = penY + rowHeight;
+
+    SDL_Surface* sheet = SDL_CreateRGBSurfaceWithFormat(0, TEXT_ATLAS_WIDTH, atlasHeight > 0 ? atlasHeight : 1,
+                                                        32, SDL_PIXELFORMAT_RGBA32);
+    if (sheet) allocNote(ALLOC_SURFACE, surfaceBytes(sheet), ALLOC_SITE);
+    for (int i = 0; i < TEXT_ATLAS_GLYPHS; i++) {
+        if (!rendered[i]) continue;
+        if (sheet) {
+            // Copy coverage as-is rather than blending onto the empty sheet
+            SDL_SetSurfaceBlendMode(rendered[i], SDL_BLENDMODE_NONE);
+            SDL_BlitSurface(rendered[i], NULL, sheet, &atlas->glyphs[i].source);
+        }
+        freeSurface(rendered[i]);
+    }
+    if (!sheet) {
+        printf("Could not create glyph atlas: %s\n", SDL_GetError());
+        return false;
+    }
+
+    atlas->texture = SDL_CreateTextureFromSurface(renderer, sheet);
+    if (atlas->texture) allocNote(ALLOC_TEXTURE, (size_t)sheet->w * sheet->h * 4, ALLOC_SITE);
+    atlas->invWidth = 1.0f / sheet->w;
+    atlas->invHeight = 1.0f / sheet->h;
+    freeSurface(sheet);
+    if (!atlas->texture) {
+        printf("Could not upload glyph atlas: %s\n", SDL_GetError());
+        return false;
+    }
+    SDL_SetTextureBlendMode(atlas->texture, SDL_BLENDMODE_BLEND);
+    atlas->lineHeight = TTF_FontHeight(font);
+    return quadBatchInit(&atlas->batch);
+}
+
+void textAtlasDestroy(TextAtlas* atlas) {
+    if (atlas->texture) {
+        int width = 0, height = 0;
+        SDL_QueryTexture(atlas->texture, NULL, NULL, &width, &height);
+        allocNoteFree(ALLOC_TEXTURE, (size_t)width * height * 4);
+        SDL_DestroyTexture(atlas->texture);
+        atlas->texture = NULL;
+    }
+    quadBatchFree(&atlas->batch);
+}
+
+// Queue a string's glyph quads; flush the batch with the atlas texture
+void textAtlasAppend(const TextAtlas* atlas, QuadBatch* batch, const char* text,
+                     int x, int y, Color color) {
+    const unsigned char* s = (const unsigned char*)text;
+    float penX = (float)x;
+    while (*s) {
+        const AtlasGlyph* glyph = &atlas->glyphs[nextGlyphSlot(&s)];
+        if (glyph->source.w > 0) {
+            quadBatchAddTextured(batch, penX, (float)y, (float)glyph->source.w, (float)glyph->source.h,
+                                 glyph->source.x * atlas->invWidth,
+                                 glyph->source.y * atlas->invHeight,
+                                 (glyph->source.x + glyph->source.w) * atlas->invWidth,
+                                 (glyph->source.y + glyph->source.h) * atlas->invHeight,
+                                 color);
+        }
+        penX += glyph->advance;
+    }
+}
+
+void textAtlasDraw(TextAtlas* atlas, SDL_Renderer* renderer, const char* text,
+                   int x, int y, Color color) {
+    if (!atlas->texture) return;
+    textAtlasAppend(atlas, &atlas->batch, text, x, y, color);
+    quadBatchFlush(&atlas->batch, renderer, atlas->texture);
+}
+
+// Same result TTF_SizeText would give, from the cached advances
+void textAtlasMeasure(const TextAtlas* atlas, const char* text, int* width, int* height) {
+    const unsigned char* s = (const unsigned char*)text;
+    int total = 0;
+    while (*s) {
+        total += atlas->glyphs[nextGlyphSlot(&s)].advance;
+    }
+    if (width) *width = total;
+    if (height) *height = atlas->lineHeight;
+}
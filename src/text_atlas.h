@@ -0,0 +1,40 @@
+#ifndef TEXT_ATLAS_H
+#define TEXT_ATLAS_H
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <stdbool.h>
+#include "sim.h"
+#include "quad_batch.h"
+
+// Font rasterized once into a single texture; strings are drawn as batched
+// textured quads instead of rendering a new surface and texture per call.
+
+#define TEXT_ATLAS_FIRST_CHAR 32 // printable ASCII, plus the bullet below
+#define TEXT_ATLAS_LAST_CHAR 126
+#define TEXT_ATLAS_BULLET (TEXT_ATLAS_LAST_CHAR - TEXT_ATLAS_FIRST_CHAR + 1)
+#define TEXT_ATLAS_GLYPHS (TEXT_ATLAS_BULLET + 1)
+#define TEXT_ATLAS_WIDTH 512
+
+typedef struct {
+    SDL_Rect source; // where the glyph sits in the atlas texture
+    int advance;
+} AtlasGlyph;
+
+typedef struct {
+    SDL_Texture* texture;
+    AtlasGlyph glyphs[TEXT_ATLAS_GLYPHS];
+    int lineHeight;
+    float invWidth, invHeight; // texel size, for texture coordinates
+    QuadBatch batch; // for textAtlasDraw
+} TextAtlas;
+
+bool textAtlasCreate(TextAtlas* atlas, SDL_Renderer* renderer, TTF_Font* font);
+void textAtlasDestroy(TextAtlas* atlas);
+void textAtlasDraw(TextAtlas* atlas, SDL_Renderer* renderer, const char* text,
+                   int x, int y, Color color);
+void textAtlasAppend(const TextAtlas* atlas, QuadBatch* batch, const char* text,
+                     int x, int y, Color color);
+void textAtlasMeasure(const TextAtlas* atlas, const char* text, int* width, int* height);
+
+#endif
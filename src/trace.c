@@ -0,0 +1,159 @@
+#include "trace.h"
+#include <stdio.h>
+
+#ifdef BQ_TRACE
+
+#include <stdlib.h>
+#include "profiler.h"
+
+#define TRACE_CHUNK_EVENTS 65536
+#define TRACE_MAX_CHUNKS 64 // per thread; later zones are dropped
+
+typedef struct {
+    const char* name;
+    uint64_t start;    // nanoseconds, profilerNow clock
+    uint64_t duration;
+} TraceEvent;
+
+// Filled by one thread only; count is published with a release store so
+// traceWrite sees whole events
+typedef struct TraceChunk {
+    struct TraceChunk* next;
+    uint32_t count;
+    TraceEvent events[TRACE_CHUNK_EVENTS];
+} TraceChunk;
+
+typedef struct TraceThread {
+    struct TraceThread* next;
+    int id;
+    int chunks;
+    uint64_t dropped;
+    TraceChunk* first;
+    TraceChunk* last;
+} TraceThread;
+
+static TraceThread* threads = NULL; // pushed with compare-and-swap
+static int threadCount = 0;
+static __thread TraceThread* local = NULL;
+
+// First zone on a thread: allocate its buffer and link it into the list
+static TraceThread* traceThread(void) {
+    TraceThread* thread = calloc(1, sizeof(TraceThread));
+    if (!thread) return NULL;
+    thread->id = __atomic_fetch_add(&threadCount, 1, __ATOMIC_RELAXED);
+    thread->next = __atomic_load_n(&threads, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&threads, &thread->next, thread, true,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+    }
+    return thread;
+}
+
+TraceZone traceZoneBegin(const char* name) {
+    TraceZone zone = {name, profilerNow()};
+    return zone;
+}
+
+void traceZoneEnd(TraceZone* zone) {
+    uint64_t end = profilerNow();
+    TraceThread* thread = local;
+    if (!thread) {
+        thread = local = traceThread();
+        if (!thread) return;
+    }
+    TraceChunk* chunk = thread->last;
+    if (!chunk || chunk->count == TRACE_CHUNK_EVENTS) {
+        TraceChunk* fresh = thread->chunks < TRACE_MAX_CHUNKS ? malloc(sizeof(TraceChunk)) : NULL;
+        if (!fresh) {
+            thread->dropped++;
+            return;
+        }
+        fresh->next = NULL;
+        fresh->count = 0;
+        if (chunk) __atomic_store_n(&chunk->next, fresh, __ATOMIC_RELEASE);
+        else __atomic_store_n(&thread->first, fresh, __ATOMIC_RELEASE);
+        thread->last = chunk = fresh;
+        thread->chunks++;
+    }
+    TraceEvent* event = &chunk->events[chunk->count];
+    event->name = zone->name;
+    event->start = zone->start;
+    event->duration = end - zone->start;
+    __atomic_store_n(&chunk->count, chunk->count + 1, __ATOMIC_RELEASE);
+}
+
+bool traceEnabled(void) {
+    return true;
+}
+
+// Complete ("X") events in microseconds from the earliest zone, one track
+// per thread
+bool traceWrite(const char* path) {
+    TraceThread* list = __atomic_load_n(&threads, __ATOMIC_ACQUIRE);
+    uint64_t epoch = UINT64_MAX;
+    for (TraceThread* thread = list; thread; thread = thread->next) {
+        for (TraceChunk* chunk = __atomic_load_n(&thread->first, __ATOMIC_ACQUIRE); chunk;
+             chunk = __atomic_load_n(&chunk->next, __ATOMIC_ACQUIRE)) {
+            uint32_t count = __atomic_load_n(&chunk->count, __ATOMIC_ACQUIRE);
+            for (uint32_t i = 0; i < count; i++) {
+                if (chunk->events[i].start < epoch) epoch = chunk->events[i].start;
+            }
+        }
+    }
+
+    FILE* file = fopen(path, "w");
+    if (!file) return false;
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"BinaryQuest\"}}");
+    for (TraceThread* thread = list; thread; thread = thread->next) {
+        fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"thread %d\"}}",
+                thread->id, thread->id);
+        for (TraceChunk* chunk = __atomic_load_n(&thread->first, __ATOMIC_ACQUIRE); chunk;
+             chunk = __atomic_load_n(&chunk->next, __ATOMIC_ACQUIRE)) {
+            uint32_t count = __atomic_load_n(&chunk->count, __ATOMIC_ACQUIRE);
+            for (uint32_t i = 0; i < count; i++) {
+                const TraceEvent* event = &chunk->events[i];
+                fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                        event->name, thread->id, (event->start - epoch) / 1e3, event->duration / 1e3);
+            }
+        }
+        if (thread->dropped > 0) {
+            printf("Trace: thread %d dropped %llu zones (buffer full)\n",
+                   thread->id, (unsigned long long)thread->dropped);
+        }
+    }
+    fprintf(file, "\n]}\n");
+    return fclose(file) == 0;
+}
+
+void traceFree(void) {
+    TraceThread* thread = __atomic_exchange_n(&threads, NULL, __ATOMIC_ACQ_REL);
+    while (thread) {
+        TraceThread* nextThread = thread->next;
+        TraceChunk* chunk = thread->first;
+        while (chunk) {
+            TraceChunk* nextChunk = chunk->next;
+            free(chunk);
+            chunk = nextChunk;
+        }
+        free(thread);
+        thread = nextThread;
+    }
+    threadCount = 0;
+    local = NULL; // only the calling thread's; others must be done
+}
+
+#else
+
+bool traceEnabled(void) {
+    return false;
+}
+
+bool traceWrite(const char* path) {
+    printf("Not writing %s: tracing is not compiled in (build with make TRACE=1)\n", path);
+    return false;
+}
+
+void traceFree(void) {
+}
+
+#endif
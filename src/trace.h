@@ -0,0 +1,49 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Chrome trace-event zones, for timelines in Perfetto or chrome://tracing.
+// TRACE_FUNCTION() at the top of a function (or TRACE_ZONE("name") at the
+// top of any block) records one complete event when the scope exits, on
+// every return path. Each thread appends to its own chunked buffer with no
+// locks; traceWrite collects every thread's events into one JSON file.
+//
+// Zones exist only in builds with BQ_TRACE defined (make TRACE=1); without
+// it the macros expand to nothing and traceWrite reports that tracing is
+// not compiled in.
+
+typedef struct {
+    const char* name; // must outlive the trace (string literals, __func__)
+    uint64_t start;
+} TraceZone;
+
+#ifdef BQ_TRACE
+
+#if !defined(__GNUC__)
+#error "BQ_TRACE zones need GCC or Clang (cleanup attribute)"
+#endif
+
+TraceZone traceZoneBegin(const char* name);
+void traceZoneEnd(TraceZone* zone);
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_ZONE(name) \
+    TraceZone TRACE_CONCAT(traceZone, __LINE__) __attribute__((cleanup(traceZoneEnd))) = traceZoneBegin(name)
+#define TRACE_FUNCTION() TRACE_ZONE(__func__)
+
+#else
+
+#define TRACE_ZONE(name) ((void)0)
+#define TRACE_FUNCTION() ((void)0)
+
+#endif
+
+bool traceEnabled(void);
+// Write every zone recorded so far; call with no zones still being recorded
+bool traceWrite(const char* path);
+void traceFree(void);
+
+#endif
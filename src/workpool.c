@@ -0,0 +1,121 @@
+#include "workpool.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+// A worker's remaining tasks, [begin, end). The owner advances begin and
+// thieves pull end back, so a range always stays contiguous.
+typedef struct {
+    pthread_mutex_t lock;
+    int begin;
+    int end;
+    char padding[64]; // keep neighbouring locks off one cache line
+} WorkRange;
+
+typedef struct {
+    WorkRange* ranges;
+    int threads;
+    WorkFunction run;
+    void* context;
+} WorkPool;
+
+typedef struct {
+    WorkPool* pool;
+    int index;
+} Worker;
+
+static bool takeOwn(WorkRange* range, int* task) {
+    pthread_mutex_lock(&range->lock);
+    bool found = range->begin < range->end;
+    if (found) *task = range->begin++;
+    pthread_mutex_unlock(&range->lock);
+    return found;
+}
+
+// Move the back half of some other worker's range into ours
+static bool steal(WorkPool* pool, int self) {
+    for (int k = 1; k < pool->threads; k++) {
+        WorkRange* victim = &pool->ranges[(self + k) % pool->threads];
+        pthread_mutex_lock(&victim->lock);
+        int remaining = victim->end - victim->begin;
+        if (remaining <= 0) {
+            pthread_mutex_unlock(&victim->lock);
+            continue;
+        }
+        int end = victim->end;
+        victim->end -= (remaining + 1) / 2;
+        int begin = victim->end;
+        pthread_mutex_unlock(&victim->lock);
+
+        WorkRange* own = &pool->ranges[self];
+        pthread_mutex_lock(&own->lock);
+        own->begin = begin;
+        own->end = end;
+        pthread_mutex_unlock(&own->lock);
+        return true;
+    }
+    return false;
+}
+
+// Tasks are never added, so once a full scan finds nothing to steal the
+// remaining work is already claimed
+static void* workerMain(void* arg) {
+    Worker* worker = arg;
+    WorkPool* pool = worker->pool;
+    for (;;) {
+        int task;
+        if (takeOwn(&pool->ranges[worker->index], &task)) {
+            pool->run(pool->context, task, worker->index);
+        } else if (!steal(pool, worker->index)) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+int workPoolRun(int taskCount, int threads, WorkFunction run, void* context) {
+    if (threads < 1) threads = 1;
+    if (threads > taskCount && taskCount > 0) threads = taskCount;
+
+    WorkPool pool = {NULL, threads, run, context};
+    pool.ranges = calloc((size_t)threads, sizeof(WorkRange));
+    Worker* workers = calloc((size_t)threads, sizeof(Worker));
+    pthread_t* handles = calloc((size_t)threads, sizeof(pthread_t));
+    if (!pool.ranges || !workers || !handles) {
+        // No memory for the pool; run everything here
+        for (int task = 0; task < taskCount; task++) run(context, task, 0);
+        free(pool.ranges);
+        free(workers);
+        free(handles);
+        return 1;
+    }
+    for (int i = 0; i < threads; i++) {
+        pthread_mutex_init(&pool.ranges[i].lock, NULL);
+        pool.ranges[i].begin = (int)((long long)taskCount * i / threads);
+        pool.ranges[i].end = (int)((long long)taskCount * (i + 1) / threads);
+        workers[i] = (Worker){&pool, i};
+    }
+
+    // Worker 0 is this thread; ranges of workers that fail to start are
+    // simply stolen by the others
+    int started = 1;
+    for (int i = 1; i < threads; i++) {
+        if (pthread_create(&handles[i], NULL, workerMain, &workers[i]) == 0) {
+            started++;
+        } else {
+            workers[i].pool = NULL;
+        }
+    }
+    workerMain(&workers[0]);
+    for (int i = 1; i < threads; i++) {
+        if (workers[i].pool) pthread_join(handles[i], NULL);
+    }
+
+    for (int i = 0; i < threads; i++) {
+        pthread_mutex_destroy(&pool.ranges[i].lock);
+    }
+    free(pool.ranges);
+    free(workers);
+    free(handles);
+    return started;
+}
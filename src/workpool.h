@@ -0,0 +1,17 @@
+#ifndef WORKPOOL_H
+#define WORKPOOL_H
+
+// Work-stealing thread pool for a fixed set of independent tasks numbered
+// 0..taskCount-1. Each worker starts with an equal contiguous range and
+// takes tasks from its front; a worker that runs dry steals the back half
+// of another worker's remaining range. Uneven task costs (short and long
+// games, easy and hard sweep points) therefore balance out without a
+// shared queue that every task has to go through.
+
+typedef void (*WorkFunction)(void* context, int task, int worker);
+
+// Run every task once; worker is in [0, threads) and identifies per-thread
+// scratch state. Returns the number of threads that ran (at least 1).
+int workPoolRun(int taskCount, int threads, WorkFunction run, void* context);
+
+#endif